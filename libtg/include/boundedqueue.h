@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace tarragon
+{
+    // A lock-free, bounded queue for any number of producer and consumer threads
+    //
+    // Each cell of the ring buffer carries a sequence number that says whether
+    // it is free for the producer, or filled for the consumer, of the current
+    // lap around the ring. Producers and consumers claim cells by advancing
+    // their position with a single compare-and-swap, then publish the cell by
+    // updating its sequence number. Batch operations claim a whole run of
+    // cells with one compare-and-swap.
+    //
+    // Pushing to a full queue and popping from an empty queue fail instead
+    // of blocking. Values are popped in the order their cells were claimed.
+    template <typename T>
+    class BoundedQueue final
+    {
+    private:
+        static constexpr size_t CacheLineSize = 64;
+
+        struct Cell
+        {
+            std::atomic<size_t> Sequence;
+            T Value;
+        };
+
+        std::unique_ptr<Cell[]> m_pcells;
+        size_t m_mask;
+
+        // Producers and consumers write different cache lines.
+        alignas(CacheLineSize) std::atomic<size_t> m_enqueue_pos{};
+        alignas(CacheLineSize) std::atomic<size_t> m_dequeue_pos{};
+
+        // Claims up to max_count consecutive cells whose sequence is
+        // position + i + offset. Returns the first claimed position and the
+        // number of cells claimed.
+        std::pair<size_t, size_t> claim(std::atomic<size_t>& position, size_t max_count, size_t offset) noexcept
+        {
+            auto pos = position.load(std::memory_order_relaxed);
+            while (true)
+            {
+                size_t count{};
+                while (count < max_count && count <= m_mask
+                    && m_pcells[(pos + count) & m_mask].Sequence.load(std::memory_order_acquire) == pos + count + offset)
+                {
+                    count++;
+                }
+
+                if (count == 0)
+                {
+                    // The first cell is either still in use from the previous
+                    // lap (full/empty), or another thread moved on already.
+                    auto current = position.load(std::memory_order_relaxed);
+                    if (current == pos)
+                        return { pos, 0 };
+                    pos = current;
+                    continue;
+                }
+
+                if (position.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                    return { pos, count };
+            }
+        }
+
+    public:
+        // Creates a queue holding at least capacity values, rounded up to a power of two
+        explicit BoundedQueue(size_t capacity)
+            : m_pcells{ std::make_unique<Cell[]>(std::bit_ceil(capacity < 2 ? size_t{ 2 } : capacity)) }
+            , m_mask{ std::bit_ceil(capacity < 2 ? size_t{ 2 } : capacity) - 1 }
+        {
+            for (size_t i = 0; i <= m_mask; i++)
+                m_pcells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        BoundedQueue(BoundedQueue const&) = delete;
+        BoundedQueue& operator= (BoundedQueue const&) = delete;
+
+        size_t capacity() const noexcept { return m_mask + 1; }
+
+        // Gets the number of values in the queue. Only a snapshot while
+        // other threads push or pop.
+        size_t size_approx() const noexcept
+        {
+            auto enqueue_pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            auto dequeue_pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+        }
+
+        // Pushes values in order until the queue is full. Returns the number of values pushed.
+        size_t try_push_batch(std::span<T const> values)
+        {
+            auto [pos, count] = claim(m_enqueue_pos, values.size(), 0);
+            for (size_t i = 0; i < count; i++)
+            {
+                auto& cell = m_pcells[(pos + i) & m_mask];
+                cell.Value = values[i];
+                cell.Sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return count;
+        }
+
+        // Pops values until values is full or the queue is empty. Returns the number of values popped.
+        size_t try_pop_batch(std::span<T> values)
+        {
+            auto [pos, count] = claim(m_dequeue_pos, values.size(), 1);
+            for (size_t i = 0; i < count; i++)
+            {
+                auto& cell = m_pcells[(pos + i) & m_mask];
+                values[i] = std::move(cell.Value);
+                cell.Sequence.store(pos + i + m_mask + 1, std::memory_order_release);
+            }
+            return count;
+        }
+
+        bool try_push(T const& value)
+        {
+            return try_push_batch(std::span<T const>{ &value, 1 }) == 1;
+        }
+
+        bool try_pop(T& value)
+        {
+            return try_pop_batch(std::span<T>{ &value, 1 }) == 1;
+        }
+    };
+}
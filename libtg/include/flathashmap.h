@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TARRAGON_FLAT_HASH_MAP_SSE2 1
+#else
+#define TARRAGON_FLAT_HASH_MAP_SSE2 0
+#endif
+
+namespace tarragon
+{
+    // A hash map that stores its keys and values in flat arrays
+    //
+    // Slots are probed in groups of 16, using one control byte per slot
+    // that holds 7 bits of the hash of its key, or marks it as empty or
+    // deleted. The control bytes of a group are compared at once, with
+    // SSE2 where available, so keys are only compared when their hash
+    // bits match. Groups are probed quadratically, starting at the group
+    // selected by the remaining hash bits.
+    //
+    // The hash must mix all bits of the key into all bits of the result.
+    // Key and T must be default constructible, free slots hold default
+    // values. Inserting may move the values, so pointers to them are only
+    // valid until the next insertion.
+    template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class FlatHashMap final
+    {
+    private:
+        static constexpr size_t GroupSize = 16;
+        static constexpr int8_t Empty = -128;
+        static constexpr int8_t Deleted = -2;
+
+        // Control bytes of full slots are the low 7 bits of the hash, so
+        // free slots are the ones with the sign bit set
+        std::vector<int8_t> m_control;
+        std::vector<Key> m_keys;
+        std::vector<T> m_values;
+        size_t m_size{};
+        // Number of full and deleted slots. Probing ends at groups with an
+        // empty slot, so there must always be some.
+        size_t m_used{};
+        [[no_unique_address]] Hash m_hash;
+        [[no_unique_address]] KeyEqual m_equal;
+
+        // Bit i is set if control byte i of the group equals control
+        static uint32_t match(int8_t const* pgroup, int8_t control) noexcept
+        {
+#if TARRAGON_FLAT_HASH_MAP_SSE2
+            auto group = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pgroup));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(control))));
+#else
+            uint32_t mask{};
+            for (size_t i = 0; i < GroupSize; i++)
+                mask |= static_cast<uint32_t>(pgroup[i] == control) << i;
+            return mask;
+#endif
+        }
+
+        // Bit i is set if slot i of the group is empty or deleted
+        static uint32_t match_free(int8_t const* pgroup) noexcept
+        {
+#if TARRAGON_FLAT_HASH_MAP_SSE2
+            auto group = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pgroup));
+            return static_cast<uint32_t>(_mm_movemask_epi8(group));
+#else
+            uint32_t mask{};
+            for (size_t i = 0; i < GroupSize; i++)
+                mask |= static_cast<uint32_t>(pgroup[i] < 0) << i;
+            return mask;
+#endif
+        }
+
+        static constexpr size_t max_used(size_t capacity) noexcept { return capacity - capacity / 8; }
+
+        size_t group_mask() const noexcept { return m_control.size() / GroupSize - 1; }
+
+        // Calls f(group) for the groups in probing order, until f returns true.
+        // Triangular steps visit every group of a power of two.
+        template <typename F>
+        void probe(size_t hash, F&& f) const
+        {
+            auto mask = group_mask();
+            auto group = (hash >> 7) & mask;
+            for (size_t step = 1; !f(group); step++)
+                group = (group + step) & mask;
+        }
+
+        // Index of the slot holding key, or capacity() if there is none
+        size_t find_slot(Key const& key, size_t hash) const
+        {
+            if (m_control.empty())
+                return capacity();
+
+            auto control = static_cast<int8_t>(hash & 0x7f);
+            auto slot = capacity();
+            probe(hash, [&](size_t group)
+            {
+                auto pgroup = m_control.data() + group * GroupSize;
+                for (auto bits = match(pgroup, control); bits != 0; bits &= bits - 1)
+                {
+                    auto candidate = group * GroupSize + static_cast<size_t>(std::countr_zero(bits));
+                    if (m_equal(m_keys[candidate], key))
+                    {
+                        slot = candidate;
+                        return true;
+                    }
+                }
+                return match(pgroup, Empty) != 0;
+            });
+            return slot;
+        }
+
+        // Index of the first free slot for a key that isn't in the map
+        size_t find_free_slot(size_t hash) const
+        {
+            size_t slot{};
+            probe(hash, [&](size_t group)
+            {
+                auto bits = match_free(m_control.data() + group * GroupSize);
+                if (bits == 0)
+                    return false;
+                slot = group * GroupSize + static_cast<size_t>(std::countr_zero(bits));
+                return true;
+            });
+            return slot;
+        }
+
+        // Moves all values into a table with the given number of slots,
+        // dropping the deleted slots
+        void rehash(size_t capacity)
+        {
+            assert(capacity >= GroupSize && std::has_single_bit(capacity));
+
+            auto control = std::exchange(m_control, std::vector<int8_t>(capacity, Empty));
+            auto keys = std::exchange(m_keys, std::vector<Key>(capacity));
+            auto values = std::exchange(m_values, std::vector<T>(capacity));
+
+            for (size_t i = 0; i < control.size(); i++)
+            {
+                if (control[i] < 0)
+                    continue;
+
+                auto slot = find_free_slot(m_hash(keys[i]));
+                m_control[slot] = control[i];
+                m_keys[slot] = std::move(keys[i]);
+                m_values[slot] = std::move(values[i]);
+            }
+            m_used = m_size;
+        }
+
+    public:
+        size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        // Number of slots, a power of two
+        size_t capacity() const noexcept { return m_control.size(); }
+
+        T* find(Key const& key)
+        {
+            auto slot = find_slot(key, m_hash(key));
+            return slot < capacity() ? &m_values[slot] : nullptr;
+        }
+
+        T const* find(Key const& key) const
+        {
+            auto slot = find_slot(key, m_hash(key));
+            return slot < capacity() ? &m_values[slot] : nullptr;
+        }
+
+        bool contains(Key const& key) const { return find(key) != nullptr; }
+
+        // Inserts a value constructed from args, unless key is already in
+        // the map. Returns the value of key and whether it was inserted.
+        template <typename... Args>
+        std::pair<T*, bool> try_emplace(Key const& key, Args&&... args)
+        {
+            auto hash = m_hash(key);
+            if (auto slot = find_slot(key, hash); slot < capacity())
+                return { &m_values[slot], false };
+
+            if (m_used + 1 > max_used(capacity()))
+            {
+                // Grow when at least half full, otherwise the table is full
+                // of deleted slots and only needs cleaning up
+                auto capacity = this->capacity();
+                rehash(capacity == 0 ? GroupSize : (m_size + 1 > capacity / 2 ? capacity * 2 : capacity));
+            }
+
+            auto slot = find_free_slot(hash);
+            if (m_control[slot] == Empty)
+                m_used++;
+            m_control[slot] = static_cast<int8_t>(hash & 0x7f);
+            m_keys[slot] = key;
+            m_values[slot] = T(std::forward<Args>(args)...);
+            m_size++;
+            return { &m_values[slot], true };
+        }
+
+        bool erase(Key const& key)
+        {
+            auto slot = find_slot(key, m_hash(key));
+            if (slot == capacity())
+                return false;
+
+            // Probing never went past a group that still has an empty slot,
+            // as groups only gain empty slots here or when rehashing. Then
+            // the slot can be reused as empty.
+            auto pgroup = m_control.data() + (slot / GroupSize) * GroupSize;
+            if (match(pgroup, Empty) != 0)
+            {
+                m_control[slot] = Empty;
+                m_used--;
+            }
+            else
+            {
+                m_control[slot] = Deleted;
+            }
+            m_keys[slot] = Key{};
+            m_values[slot] = T{};
+            m_size--;
+            return true;
+        }
+
+        // Removes all values, keeping the slots
+        void clear()
+        {
+            std::fill(std::begin(m_control), std::end(m_control), Empty);
+            std::fill(std::begin(m_keys), std::end(m_keys), Key{});
+            std::fill(std::begin(m_values), std::end(m_values), T{});
+            m_size = 0;
+            m_used = 0;
+        }
+
+        // Makes room for count values without growing
+        void reserve(size_t count)
+        {
+            auto capacity = GroupSize;
+            while (max_used(capacity) < count)
+                capacity *= 2;
+            if (capacity > this->capacity())
+                rehash(capacity);
+        }
+
+        // Calls f(key, value) for each value, in no particular order
+        template <typename F>
+        void for_each(F&& f)
+        {
+            for (size_t slot = 0; slot < m_control.size(); slot++)
+            {
+                if (m_control[slot] >= 0)
+                    f(m_keys[slot], m_values[slot]);
+            }
+        }
+
+        template <typename F>
+        void for_each(F&& f) const
+        {
+            for (size_t slot = 0; slot < m_control.size(); slot++)
+            {
+                if (m_control[slot] >= 0)
+                    f(m_keys[slot], m_values[slot]);
+            }
+        }
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace tarragon
+{
+    // Counts durations in buckets of exponentially growing width
+    //
+    // Bucket i counts durations of [2^i, 2^(i+1)) nanoseconds, the first bucket
+    // also counts shorter ones and the last bucket also counts longer ones.
+    // Recording is lock-free and can happen on any thread.
+    class LatencyHistogram final
+    {
+    public:
+        using Duration = std::chrono::nanoseconds;
+
+        // 2^40 ns is about 18 minutes
+        static constexpr size_t BucketCount = 40;
+
+    private:
+        std::array<std::atomic<uint64_t>, BucketCount> m_buckets{};
+
+        static constexpr size_t bucket_index(Duration duration) noexcept
+        {
+            auto ticks = static_cast<uint64_t>(duration.count() > 0 ? duration.count() : 0);
+            auto index = ticks > 0 ? static_cast<size_t>(std::bit_width(ticks)) - 1 : 0;
+            return index < BucketCount ? index : BucketCount - 1;
+        }
+
+    public:
+        void record(Duration duration) noexcept
+        {
+            m_buckets[bucket_index(duration)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t count() const noexcept
+        {
+            uint64_t total{};
+            for (auto const& bucket : m_buckets)
+                total += bucket.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        uint64_t bucket_count(size_t index) const noexcept
+        {
+            return m_buckets.at(index).load(std::memory_order_relaxed);
+        }
+
+        // Gets the upper bound of the bucket containing the given quantile
+        // (0 to 1) of the recorded durations, or zero if nothing was recorded
+        Duration quantile(double q) const noexcept
+        {
+            auto total = count();
+            if (total == 0)
+                return Duration::zero();
+
+            auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+            uint64_t seen{};
+            for (size_t i = 0; i < BucketCount; i++)
+            {
+                seen += m_buckets[i].load(std::memory_order_relaxed);
+                if (seen >= rank)
+                    return Duration{ int64_t{ 2 } << i };
+            }
+            return Duration{ int64_t{ 2 } << (BucketCount - 1) };
+        }
+
+        void reset() noexcept
+        {
+            for (auto& bucket : m_buckets)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    };
+}
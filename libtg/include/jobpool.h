@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace tarragon
+{
+    // A pool of worker threads that run jobs
+    //
+    // Each worker has its own job deque. Jobs submitted by a running job go
+    // to the deque of its worker and are run last in, first out, so that
+    // follow-up work stays on the thread whose caches hold its data. Jobs
+    // submitted from other threads are distributed round-robin. Workers that
+    // run out of jobs steal the oldest jobs of the other workers, and sleep
+    // when there are none left.
+    //
+    // Jobs that haven't started when the pool is destroyed are discarded.
+    class JobPool final
+    {
+    public:
+        using Job = std::function<void()>;
+
+    private:
+        struct Worker
+        {
+            std::mutex Mutex;
+            std::deque<Job> Jobs;
+        };
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::atomic<size_t> m_next_worker{};
+
+        // Number of jobs in all deques. Incremented before a job is pushed,
+        // so it never underflows when the job is popped right away.
+        std::atomic<size_t> m_queued_count{};
+        std::mutex m_wake_mtx;
+        std::condition_variable_any m_wake_cv;
+
+        std::vector<std::jthread> m_threads;
+
+        bool try_pop(size_t index, Job& job);
+
+        void worker_loop(std::stop_token stop_token, size_t index);
+
+    public:
+        // Gets the number of workers that keeps all hardware threads busy
+        static size_t default_worker_count() noexcept;
+
+        explicit JobPool(size_t worker_count = default_worker_count());
+        ~JobPool();
+
+        JobPool(JobPool const&) = delete;
+        JobPool& operator= (JobPool const&) = delete;
+
+        size_t worker_count() const noexcept { return m_workers.size(); }
+
+        // Queues a job to run on one of the workers
+        void submit(Job job);
+    };
+}
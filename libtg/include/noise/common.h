@@ -1,7 +1,27 @@
 #pragma once
 
+#include <glm/vec3.hpp>
+
 namespace tarragon::noise
 {
+    // A closed range of values, bounds may be infinite
+    template <typename T>
+    struct Interval
+    {
+        T Lower;
+        T Upper;
+    };
+
+    // An axis-aligned box of positions, bounds may be infinite
+    template <typename T>
+    struct Box
+    {
+        glm::vec<3, T> Lower;
+        glm::vec<3, T> Upper;
+
+        friend bool operator==(Box const&, Box const&) = default;
+    };
+
     template <typename T>
     constexpr T scurve3(T a)
     {
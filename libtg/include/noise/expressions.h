@@ -0,0 +1,792 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "noise/common.h"
+#include "noise/generator.h"
+#include "noise/graph.h"
+#include "noise/modules.h"
+
+// Compile-time composition of noise graphs
+//
+// The factory functions in this namespace mirror the ones in modules.h, but
+// return expressions: concrete types that hold their sources by value. A
+// whole graph is a single type, so the compiler can inline every node into
+// one function instead of calling through a std::function per node.
+//
+//     auto graph = expr::displace(expr::ridged_multi<float>(...), expr::billow<float>(...), ...);
+//     FloatModule module = graph.type_erase();
+//
+// Expressions produce exactly the same values as the equivalent modules, and
+// are described by the same graph nodes (see graph.h), which type_erase()
+// passes on to the module.
+namespace tarragon::noise::expr
+{
+    template <typename T>
+    using Position = typename BasicModule<T>::Position;
+
+    // Converts factory arguments to graph node parameters
+    template <typename... TArgs>
+    std::vector<double> parameters(TArgs... args)
+    {
+        return { static_cast<double>(args)... };
+    }
+
+    // Creates the graph node describing an expression
+    template <typename T, typename... TSources>
+    graph::NodePtr<T> make_node(graph::NodeType type, std::vector<double> parameters, TSources const&... sources)
+    {
+        return std::make_shared<graph::Node<T> const>(graph::Node<T>{ type, std::move(parameters), { sources.node()... }, {} });
+    }
+
+    // A buffer for the intermediate values of one batch evaluation
+    //
+    // The storage comes from a pool per thread and goes back to it when the
+    // buffer is destroyed. Nested expressions each take their own buffer,
+    // and evaluating batches of the same size again allocates nothing.
+    // The values are unspecified until written.
+    template <typename U>
+    class ScratchBuffer final
+    {
+    private:
+        std::vector<U> m_values;
+
+        static std::vector<std::vector<U>>& pool()
+        {
+            thread_local std::vector<std::vector<U>> buffers{};
+            return buffers;
+        }
+
+    public:
+        explicit ScratchBuffer(size_t size)
+        {
+            auto& buffers = pool();
+            if (!buffers.empty())
+            {
+                m_values = std::move(buffers.back());
+                buffers.pop_back();
+            }
+            m_values.resize(size);
+        }
+
+        ~ScratchBuffer()
+        {
+            pool().push_back(std::move(m_values));
+        }
+
+        ScratchBuffer(ScratchBuffer const&) = delete;
+        ScratchBuffer& operator= (ScratchBuffer const&) = delete;
+
+        U& operator[](size_t i) noexcept { return m_values[i]; }
+        U const& operator[](size_t i) const noexcept { return m_values[i]; }
+
+        operator std::span<U>() noexcept { return m_values; }
+        operator std::span<U const>() const noexcept { return m_values; }
+    };
+
+    // Base of all expressions, providing evaluation and type erasure
+    //
+    // Derived must implement T evaluate(Position<T>) and may implement
+    // void evaluate_batch(std::span<Position<T> const>, std::span<T>). If it
+    // doesn't, batches are evaluated one position at a time. Derived passes
+    // the node describing it to the constructor.
+    template <typename T, typename Derived>
+    class ExpressionBase
+    {
+    private:
+        graph::NodePtr<T> m_pnode;
+
+    protected:
+        explicit ExpressionBase(graph::NodePtr<T> pnode)
+            : m_pnode{ std::move(pnode) }
+        { }
+
+    public:
+        using value_type = T;
+
+        // Gets the graph node describing this expression
+        graph::NodePtr<T> const& node() const noexcept { return m_pnode; }
+
+        // Gets the output value for a single position
+        T operator()(Position<T> const& pos) const { return derived().evaluate(pos); }
+
+        // Gets the output values for a batch of positions.
+        // values must hold at least as many elements as positions.
+        void operator()(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            assert(values.size() >= positions.size());
+
+            if constexpr (requires { derived().evaluate_batch(positions, values); })
+                derived().evaluate_batch(positions, values);
+            else
+            {
+                for (size_t i = 0; i < positions.size(); i++)
+                    values[i] = derived().evaluate(positions[i]);
+            }
+        }
+
+        // Turns this expression into a module, which can be stored
+        // and combined without knowing the expression type
+        BasicModule<T> type_erase() const
+        {
+            return BasicModule<T>
+            {
+                [expression = derived()](Position<T> pos)
+                {
+                    return expression(pos);
+                },
+                [expression = derived()](std::span<Position<T> const> positions, std::span<T> values)
+                {
+                    expression(positions, values);
+                }
+            }.with_node(m_pnode);
+        }
+
+    private:
+        Derived const& derived() const { return static_cast<Derived const&>(*this); }
+    };
+
+    template <typename E>
+    concept Expression = std::derived_from<E, ExpressionBase<typename E::value_type, E>>;
+
+    template <typename E0, typename... E>
+    concept SamePrecision = (std::same_as<typename E0::value_type, typename E::value_type> && ...);
+
+    // Outputs the value of a module
+    //
+    // Used to mix modules into expressions, e.g. for nodes that have no
+    // expression counterpart.
+    template <typename T>
+    class ModuleExpression final : public ExpressionBase<T, ModuleExpression<T>>
+    {
+    private:
+        using Base = ExpressionBase<T, ModuleExpression>;
+
+        BasicModule<T> m_module;
+
+    public:
+        explicit ModuleExpression(BasicModule<T> source)
+            : Base{ graph::from_module(source) }, m_module{ std::move(source) }
+        { }
+
+        T evaluate(Position<T> pos) const { return m_module(pos); }
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const { m_module(positions, values); }
+    };
+
+    template <typename T>
+    class Constant final : public ExpressionBase<T, Constant<T>>
+    {
+    private:
+        using Base = ExpressionBase<T, Constant>;
+
+        T m_value;
+
+    public:
+        explicit Constant(double value)
+            : Base{ make_node<T>(graph::NodeType::Constant, parameters(value)) },
+              m_value{ static_cast<T>(value) }
+        { }
+
+        T evaluate(Position<T>) const { return m_value; }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            std::fill_n(std::begin(values), positions.size(), m_value);
+        }
+    };
+
+    template <typename T>
+    class Perlin final : public ExpressionBase<T, Perlin<T>>
+    {
+    private:
+        using Base = ExpressionBase<T, Perlin>;
+
+        T m_frequency;
+        T m_lacunarity;
+        uint32_t m_octave_count;
+        T m_persistence;
+        NoiseQuality m_quality;
+        int32_t m_seed;
+
+    public:
+        Perlin(double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
+            : Base{ make_node<T>(graph::NodeType::Perlin, parameters(frequency, lacunarity, octave_count, persistence, quality, seed)) },
+              m_frequency{ static_cast<T>(frequency) },
+              m_lacunarity{ static_cast<T>(lacunarity) },
+              m_octave_count{ octave_count },
+              m_persistence{ static_cast<T>(persistence) },
+              m_quality{ quality },
+              m_seed{ seed }
+        { }
+
+        T evaluate(Position<T> pos) const
+        {
+            T value{};
+            T current_persistence{ 1 };
+
+            pos *= m_frequency;
+
+            for (int32_t octave = 0; static_cast<uint32_t>(octave) < m_octave_count; octave++)
+            {
+                int32_t octave_seed = (m_seed + octave) & INT32_MAX;
+                auto signal = gradient_coherent_noise_3d(pos, octave_seed, m_quality);
+                value += signal * current_persistence;
+
+                pos *= m_lacunarity;
+                current_persistence *= m_persistence;
+            }
+
+            return value;
+        }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            ScratchBuffer<Position<T>> octave_positions(positions.size());
+            ScratchBuffer<T> signals(positions.size());
+            T current_persistence{ 1 };
+
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                octave_positions[i] = positions[i] * m_frequency;
+                values[i] = T{ 0 };
+            }
+
+            for (int32_t octave = 0; static_cast<uint32_t>(octave) < m_octave_count; octave++)
+            {
+                int32_t octave_seed = (m_seed + octave) & INT32_MAX;
+                gradient_coherent_noise_3d(octave_positions, signals, octave_seed, m_quality);
+
+                for (size_t i = 0; i < positions.size(); i++)
+                {
+                    values[i] += signals[i] * current_persistence;
+                    octave_positions[i] *= m_lacunarity;
+                }
+                current_persistence *= m_persistence;
+            }
+        }
+    };
+
+    template <typename T>
+    class Billow final : public ExpressionBase<T, Billow<T>>
+    {
+    private:
+        using Base = ExpressionBase<T, Billow>;
+
+        T m_frequency;
+        T m_lacunarity;
+        uint32_t m_octave_count;
+        T m_persistence;
+        NoiseQuality m_quality;
+        int32_t m_seed;
+
+    public:
+        Billow(double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
+            : Base{ make_node<T>(graph::NodeType::Billow, parameters(frequency, lacunarity, octave_count, persistence, quality, seed)) },
+              m_frequency{ static_cast<T>(frequency) },
+              m_lacunarity{ static_cast<T>(lacunarity) },
+              m_octave_count{ octave_count },
+              m_persistence{ static_cast<T>(persistence) },
+              m_quality{ quality },
+              m_seed{ seed }
+        { }
+
+        T evaluate(Position<T> pos) const
+        {
+            T value{};
+            T current_persistence{ 1 };
+
+            pos *= m_frequency;
+
+            for (int32_t current_octave = 0; static_cast<uint32_t>(current_octave) < m_octave_count; current_octave++)
+            {
+                // Get the coherent-noise value from the input value and add it to the final result.
+                int32_t octave_seed = (m_seed + current_octave) & INT32_MAX;
+                auto signal = gradient_coherent_noise_3d(pos, octave_seed, m_quality);
+                signal = T{ 2 } * glm::abs(signal) - T{ 1 };
+                value += signal * current_persistence;
+
+                // Prepare the next octave.
+                pos *= m_lacunarity;
+                current_persistence *= m_persistence;
+            }
+            value += T{ 0.5 };
+
+            return value;
+        }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            ScratchBuffer<Position<T>> octave_positions(positions.size());
+            ScratchBuffer<T> signals(positions.size());
+            T current_persistence{ 1 };
+
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                octave_positions[i] = positions[i] * m_frequency;
+                values[i] = T{ 0 };
+            }
+
+            for (int32_t current_octave = 0; static_cast<uint32_t>(current_octave) < m_octave_count; current_octave++)
+            {
+                int32_t octave_seed = (m_seed + current_octave) & INT32_MAX;
+                gradient_coherent_noise_3d(octave_positions, signals, octave_seed, m_quality);
+
+                for (size_t i = 0; i < positions.size(); i++)
+                {
+                    auto signal = T{ 2 } * glm::abs(signals[i]) - T{ 1 };
+                    values[i] += signal * current_persistence;
+                    octave_positions[i] *= m_lacunarity;
+                }
+                current_persistence *= m_persistence;
+            }
+
+            for (size_t i = 0; i < positions.size(); i++)
+                values[i] += T{ 0.5 };
+        }
+    };
+
+    template <typename T>
+    class RidgedMulti final : public ExpressionBase<T, RidgedMulti<T>>
+    {
+    private:
+        using Base = ExpressionBase<T, RidgedMulti>;
+
+        static constexpr T Offset{ 1 };
+        static constexpr T Gain{ 2 };
+
+        T m_frequency;
+        T m_lacunarity;
+        uint32_t m_octave_count;
+        NoiseQuality m_quality;
+        int32_t m_seed;
+        std::array<T, RidgedMultiMaxOctaveCount> m_spectral_weights{};
+
+    public:
+        RidgedMulti(double frequency, double lacunarity, uint32_t octave_count, NoiseQuality quality, int32_t seed)
+            : Base{ make_node<T>(graph::NodeType::RidgedMulti, parameters(frequency, lacunarity, octave_count, quality, seed)) },
+              m_frequency{ static_cast<T>(frequency) },
+              m_lacunarity{ static_cast<T>(lacunarity) },
+              m_octave_count{ octave_count },
+              m_quality{ quality },
+              m_seed{ seed }
+        {
+            assert(octave_count <= RidgedMultiMaxOctaveCount);
+
+            // The spectral weights are computed in double precision for all T.
+            const double h = 1.0;
+            double weight_frequency = 1.0;
+            for (auto& weight : m_spectral_weights)
+            {
+                weight = static_cast<T>(glm::pow(weight_frequency, -h));
+                weight_frequency *= lacunarity;
+            }
+        }
+
+        T evaluate(Position<T> pos) const
+        {
+            T value{};
+            T weight{ 1 };
+
+            pos *= m_frequency;
+
+            for (int32_t octave = 0; static_cast<uint32_t>(octave) < m_octave_count; octave++)
+            {
+                // Get the coherent-noise value.
+                int32_t octave_seed = (m_seed + octave) & 0x7fffffff;
+                auto signal = gradient_coherent_noise_3d(pos, octave_seed, m_quality);
+
+                // Make the ridges.
+                signal = Offset - glm::abs(signal);
+
+                // Square the signal to increase the sharpness of the ridges.
+                signal *= signal;
+
+                // The weighting from the previous octave is applied to the signal.
+                // Larger values have higher weights, producing sharp points along the
+                // ridges.
+                signal *= weight;
+
+                // Weight successive contributions by the previous signal.
+                weight = signal * Gain;
+                if (weight > T{ 1 })
+                    weight = T{ 1 };
+                if (weight < T{ 0 })
+                    weight = T{ 0 };
+
+                // Add the signal to the output value.
+                value += (signal * m_spectral_weights[octave]);
+
+                pos *= m_lacunarity;
+            }
+
+            return (value * T{ 1.25 }) - T{ 1 };
+        }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            ScratchBuffer<Position<T>> octave_positions(positions.size());
+            ScratchBuffer<T> signals(positions.size());
+            ScratchBuffer<T> weights(positions.size());
+
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                octave_positions[i] = positions[i] * m_frequency;
+                values[i] = T{ 0 };
+                weights[i] = T{ 1 };
+            }
+
+            for (int32_t octave = 0; static_cast<uint32_t>(octave) < m_octave_count; octave++)
+            {
+                int32_t octave_seed = (m_seed + octave) & 0x7fffffff;
+                gradient_coherent_noise_3d(octave_positions, signals, octave_seed, m_quality);
+
+                for (size_t i = 0; i < positions.size(); i++)
+                {
+                    // Same steps as the single-value version above.
+                    auto signal = Offset - glm::abs(signals[i]);
+                    signal *= signal;
+                    signal *= weights[i];
+
+                    weights[i] = signal * Gain;
+                    if (weights[i] > T{ 1 })
+                        weights[i] = T{ 1 };
+                    if (weights[i] < T{ 0 })
+                        weights[i] = T{ 0 };
+
+                    values[i] += (signal * m_spectral_weights[octave]);
+                    octave_positions[i] *= m_lacunarity;
+                }
+            }
+
+            for (size_t i = 0; i < positions.size(); i++)
+                values[i] = (values[i] * T{ 1.25 }) - T{ 1 };
+        }
+    };
+
+    // Maps each output value of a source expression
+    template <Expression Source, typename Op>
+    class MapValues final : public ExpressionBase<typename Source::value_type, MapValues<Source, Op>>
+    {
+    private:
+        using T = typename Source::value_type;
+        using Base = ExpressionBase<T, MapValues>;
+
+        Source m_source;
+        Op m_op;
+
+    public:
+        // type and parameters describe what op does, see graph::Node
+        MapValues(Source source, Op op, graph::NodeType type, std::vector<double> parameters = {})
+            : Base{ make_node<T>(type, std::move(parameters), source) },
+              m_source{ std::move(source) }, m_op{ std::move(op) }
+        { }
+
+        T evaluate(Position<T> pos) const { return m_op(m_source(pos)); }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            m_source(positions, values);
+            for (size_t i = 0; i < positions.size(); i++)
+                values[i] = m_op(values[i]);
+        }
+    };
+
+    // Combines the output values of two source expressions
+    template <Expression Source0, Expression Source1, typename Op>
+        requires SamePrecision<Source0, Source1>
+    class CombineValues final : public ExpressionBase<typename Source0::value_type, CombineValues<Source0, Source1, Op>>
+    {
+    private:
+        using T = typename Source0::value_type;
+        using Base = ExpressionBase<T, CombineValues>;
+
+        Source0 m_source0;
+        Source1 m_source1;
+        Op m_op;
+
+    public:
+        // type describes what op does, see graph::Node
+        CombineValues(Source0 source0, Source1 source1, Op op, graph::NodeType type)
+            : Base{ make_node<T>(type, {}, source0, source1) },
+              m_source0{ std::move(source0) }, m_source1{ std::move(source1) }, m_op{ std::move(op) }
+        { }
+
+        T evaluate(Position<T> pos) const { return m_op(m_source0(pos), m_source1(pos)); }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            ScratchBuffer<T> values1(positions.size());
+            m_source0(positions, values);
+            m_source1(positions, values1);
+            for (size_t i = 0; i < positions.size(); i++)
+                values[i] = m_op(values[i], values1[i]);
+        }
+    };
+
+    // Transforms each input position before passing it to a source expression
+    template <Expression Source, typename Op>
+    class MapPositions final : public ExpressionBase<typename Source::value_type, MapPositions<Source, Op>>
+    {
+    private:
+        using T = typename Source::value_type;
+        using Base = ExpressionBase<T, MapPositions>;
+
+        Source m_source;
+        Op m_op;
+
+    public:
+        // type and parameters describe what op does, see graph::Node
+        MapPositions(Source source, Op op, graph::NodeType type, std::vector<double> parameters = {})
+            : Base{ make_node<T>(type, std::move(parameters), source) },
+              m_source{ std::move(source) }, m_op{ std::move(op) }
+        { }
+
+        T evaluate(Position<T> pos) const { return m_source(m_op(pos)); }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            ScratchBuffer<Position<T>> mapped_positions(positions.size());
+            for (size_t i = 0; i < positions.size(); i++)
+                mapped_positions[i] = m_op(positions[i]);
+            m_source(mapped_positions, values);
+        }
+    };
+
+    template <Expression Source0, Expression Source1, Expression Control>
+        requires SamePrecision<Source0, Source1, Control>
+    class Blend final : public ExpressionBase<typename Source0::value_type, Blend<Source0, Source1, Control>>
+    {
+    private:
+        using T = typename Source0::value_type;
+        using Base = ExpressionBase<T, Blend>;
+
+        Source0 m_source0;
+        Source1 m_source1;
+        Control m_control;
+
+    public:
+        Blend(Source0 source0, Source1 source1, Control control)
+            : Base{ make_node<T>(graph::NodeType::Blend, {}, source0, source1, control) },
+              m_source0{ std::move(source0) }, m_source1{ std::move(source1) }, m_control{ std::move(control) }
+        { }
+
+        T evaluate(Position<T> pos) const
+        {
+            return glm::mix(m_source0(pos), m_source1(pos), m_control(pos));
+        }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            ScratchBuffer<T> values1(positions.size());
+            ScratchBuffer<T> control_values(positions.size());
+            m_source0(positions, values);
+            m_source1(positions, values1);
+            m_control(positions, control_values);
+
+            for (size_t i = 0; i < positions.size(); i++)
+                values[i] = glm::mix(values[i], values1[i], control_values[i]);
+        }
+    };
+
+    template <Expression Source, Expression XDisplace, Expression YDisplace, Expression ZDisplace>
+        requires SamePrecision<Source, XDisplace, YDisplace, ZDisplace>
+    class Displace final : public ExpressionBase<typename Source::value_type, Displace<Source, XDisplace, YDisplace, ZDisplace>>
+    {
+    private:
+        using T = typename Source::value_type;
+        using Base = ExpressionBase<T, Displace>;
+
+        Source m_source;
+        XDisplace m_xdisplace;
+        YDisplace m_ydisplace;
+        ZDisplace m_zdisplace;
+
+    public:
+        Displace(Source source, XDisplace xdisplace, YDisplace ydisplace, ZDisplace zdisplace)
+            : Base{ make_node<T>(graph::NodeType::Displace, {}, source, xdisplace, ydisplace, zdisplace) },
+              m_source{ std::move(source) },
+              m_xdisplace{ std::move(xdisplace) },
+              m_ydisplace{ std::move(ydisplace) },
+              m_zdisplace{ std::move(zdisplace) }
+        { }
+
+        T evaluate(Position<T> pos) const
+        {
+            auto displaced_pos = pos +
+                Position<T>{ m_xdisplace(pos), m_ydisplace(pos), m_zdisplace(pos) };
+            return m_source(displaced_pos);
+        }
+
+        void evaluate_batch(std::span<Position<T> const> positions, std::span<T> values) const
+        {
+            ScratchBuffer<T> xvalues(positions.size()), yvalues(positions.size()), zvalues(positions.size());
+            m_xdisplace(positions, xvalues);
+            m_ydisplace(positions, yvalues);
+            m_zdisplace(positions, zvalues);
+
+            ScratchBuffer<Position<T>> displaced_positions(positions.size());
+            for (size_t i = 0; i < positions.size(); i++)
+                displaced_positions[i] = positions[i] + Position<T>{ xvalues[i], yvalues[i], zvalues[i] };
+            m_source(displaced_positions, values);
+        }
+    };
+
+    // See Module factories in modules.h for documentation of the parameters.
+
+    template <typename T>
+    ModuleExpression<T> from_module(BasicModule<T> source)
+    {
+        return ModuleExpression<T>{ std::move(source) };
+    }
+
+    template <typename T = double>
+    Constant<T> constant(double value = ConstantDefaultValue)
+    {
+        return Constant<T>{ value };
+    }
+
+    template <typename T = double>
+    Perlin<T> perlin(
+        double frequency = PerlinDefaultFrequency,
+        double lacunarity = PerlinDefaultLacunarity,
+        uint32_t octave_count = PerlinDefaultOctaveCount,
+        double persistence = PerlinDefaultPersistence,
+        NoiseQuality quality = DefaultQuality,
+        int32_t seed = DefaultSeed)
+    {
+        return Perlin<T>{ frequency, lacunarity, octave_count, persistence, quality, seed };
+    }
+
+    template <typename T = double>
+    Billow<T> billow(
+        double frequency = BillowDefaultFrequency,
+        double lacunarity = BillowDefaultLacunarity,
+        uint32_t octave_count = BillowDefaultOctaveCount,
+        double persistence = BillowDefaultPersistence,
+        NoiseQuality quality = DefaultQuality,
+        int32_t seed = DefaultSeed)
+    {
+        return Billow<T>{ frequency, lacunarity, octave_count, persistence, quality, seed };
+    }
+
+    template <typename T = double>
+    RidgedMulti<T> ridged_multi(
+        double frequency = RidgedMultiDefaultFrequency,
+        double lacunarity = RidgedMultiDefaultLacunarity,
+        uint32_t octave_count = RidgedMultiDefaultOctaveCount,
+        NoiseQuality quality = DefaultQuality,
+        int32_t seed = DefaultSeed)
+    {
+        return RidgedMulti<T>{ frequency, lacunarity, octave_count, quality, seed };
+    }
+
+    template <Expression Source>
+    auto abs(Source source)
+    {
+        using T = typename Source::value_type;
+        return MapValues{ std::move(source), [](T value) { return glm::abs(value); }, graph::NodeType::Abs };
+    }
+
+    template <Expression Source>
+    auto invert(Source source)
+    {
+        using T = typename Source::value_type;
+        return MapValues{ std::move(source), [](T value) { return T{ -1 } * value; }, graph::NodeType::Invert };
+    }
+
+    template <Expression Source>
+    auto clamp(Source source, double lower_bound = ClampDefaultLowerBound, double upper_bound = ClampDefaultUpperBound)
+    {
+        using T = typename Source::value_type;
+        return MapValues{ std::move(source), [lower_bound = static_cast<T>(lower_bound), upper_bound = static_cast<T>(upper_bound)](T value)
+        {
+            return glm::clamp(value, lower_bound, upper_bound);
+        }, graph::NodeType::Clamp, parameters(lower_bound, upper_bound) };
+    }
+
+    template <Expression Source>
+    auto scale_bias(Source source, double scale = ScaleBiasDefaultScale, double bias = ScaleBiasDefaultBias)
+    {
+        using T = typename Source::value_type;
+        return MapValues{ std::move(source), [scale = static_cast<T>(scale), bias = static_cast<T>(bias)](T value)
+        {
+            return value * scale + bias;
+        }, graph::NodeType::ScaleBias, parameters(scale, bias) };
+    }
+
+    template <Expression Source0, Expression Source1>
+        requires SamePrecision<Source0, Source1>
+    auto add(Source0 source0, Source1 source1)
+    {
+        using T = typename Source0::value_type;
+        return CombineValues{ std::move(source0), std::move(source1), [](T value0, T value1) { return value0 + value1; }, graph::NodeType::Add };
+    }
+
+    template <Expression Source0, Expression Source1>
+        requires SamePrecision<Source0, Source1>
+    auto multiply(Source0 source0, Source1 source1)
+    {
+        using T = typename Source0::value_type;
+        return CombineValues{ std::move(source0), std::move(source1), [](T value0, T value1) { return value0 * value1; }, graph::NodeType::Multiply };
+    }
+
+    template <Expression Source0, Expression Source1>
+        requires SamePrecision<Source0, Source1>
+    auto max(Source0 source0, Source1 source1)
+    {
+        using T = typename Source0::value_type;
+        return CombineValues{ std::move(source0), std::move(source1), [](T value0, T value1) { return glm::max(value0, value1); }, graph::NodeType::Max };
+    }
+
+    template <Expression Source0, Expression Source1>
+        requires SamePrecision<Source0, Source1>
+    auto min(Source0 source0, Source1 source1)
+    {
+        using T = typename Source0::value_type;
+        return CombineValues{ std::move(source0), std::move(source1), [](T value0, T value1) { return glm::min(value0, value1); }, graph::NodeType::Min };
+    }
+
+    template <Expression Source>
+    auto scale_point(Source source, glm::dvec3 const& scale_factor = ScalePointDefaultScaleFactor)
+    {
+        using T = typename Source::value_type;
+        return MapPositions{ std::move(source), [scale_factor = Position<T>{ scale_factor }](Position<T> pos)
+        {
+            return pos * scale_factor;
+        }, graph::NodeType::ScalePoint, parameters(scale_factor.x, scale_factor.y, scale_factor.z) };
+    }
+
+    template <Expression Source>
+    auto translate_point(Source source, glm::dvec3 const& translation = TranslateDefaultTranslation)
+    {
+        using T = typename Source::value_type;
+        return MapPositions{ std::move(source), [translation = Position<T>{ translation }](Position<T> pos)
+        {
+            return pos + translation;
+        }, graph::NodeType::TranslatePoint, parameters(translation.x, translation.y, translation.z) };
+    }
+
+    template <Expression Source0, Expression Source1, Expression Control>
+        requires SamePrecision<Source0, Source1, Control>
+    auto blend(Source0 source0, Source1 source1, Control control)
+    {
+        return Blend{ std::move(source0), std::move(source1), std::move(control) };
+    }
+
+    template <Expression Source, Expression XDisplace, Expression YDisplace, Expression ZDisplace>
+        requires SamePrecision<Source, XDisplace, YDisplace, ZDisplace>
+    auto displace(Source source, XDisplace xdisplace, YDisplace ydisplace, ZDisplace zdisplace)
+    {
+        return Displace{ std::move(source), std::move(xdisplace), std::move(ydisplace), std::move(zdisplace) };
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 #include <glm/vec3.hpp>
 
@@ -15,7 +16,35 @@ namespace tarragon::noise
     //
     // For an explanation of the difference between gradient noise and
     // value noise, see the comments for the gradient_noise_3d function.
+    //
+    // The single-precision overloads run the same algorithm in float.
     double gradient_coherent_noise_3d(glm::dvec3 const& pos, int32_t seed = 0, NoiseQuality quality = NoiseQuality::Standard);
+    float gradient_coherent_noise_3d(glm::vec3 const& pos, int32_t seed = 0, NoiseQuality quality = NoiseQuality::Standard);
+
+    // Generates gradient-coherent-noise values for a batch of input values.
+    //
+    // values must hold at least as many elements as positions. Each output
+    // value is identical to the one returned by the single-value overload
+    // of the same precision.
+    void gradient_coherent_noise_3d(std::span<glm::dvec3 const> positions, std::span<double> values, int32_t seed = 0, NoiseQuality quality = NoiseQuality::Standard);
+    void gradient_coherent_noise_3d(std::span<glm::vec3 const> positions, std::span<float> values, int32_t seed = 0, NoiseQuality quality = NoiseQuality::Standard);
+
+    // Bound on the absolute value of gradient-coherent-noise
+    //
+    // Values are interpolated from the gradient noise of the corners of the
+    // cube around the position, and the weighted mean distance to those
+    // corners is at most sqrt(3) / 2, so values lie within 2.12 * sqrt(3) / 2.
+    // Values beyond -1.0 to +1.0 are rare in practice. Padded for rounding.
+    constexpr double GradientCoherentNoiseBound = 2.12 * 0.8660254037844386 * 1.001;
+
+    // Gets a range that the gradient-coherent-noise values of all positions
+    // in a box provably lie in.
+    //
+    // Boxes that lie in a few unit cubes are bounded by interpolating the
+    // ranges of the gradient noise of the cube corners. Larger boxes get
+    // the global bound.
+    Interval<double> gradient_coherent_noise_3d_range(Box<double> const& box, int32_t seed = 0, NoiseQuality quality = NoiseQuality::Standard);
+    Interval<float> gradient_coherent_noise_3d_range(Box<float> const& box, int32_t seed = 0, NoiseQuality quality = NoiseQuality::Standard);
     
     // Generates a gradient-noise value from the coordinates of a
     // three-dimensional input value and the integer coordinates of a
@@ -42,6 +71,7 @@ namespace tarragon::noise
     // always returns the same output value if the same input value is passed
     // to it.
     double gradient_noise_3d(glm::dvec3 const& fpos, glm::ivec3 const& ipos, int32_t seed = 0);
+    float gradient_noise_3d(glm::vec3 const& fpos, glm::ivec3 const& ipos, int32_t seed = 0);
     
     // Generates a value-coherent-noise value from the coordinates of a
     // three-dimensional input value.
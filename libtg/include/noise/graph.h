@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "noise/modules.h"
+
+// Intermediate representation of noise graphs
+//
+// Every module created by a factory function in modules.h, or by type
+// erasing an expression (see expressions.h), carries a node that describes
+// it: the factory, its parameters and the nodes of its source modules. Modules created from plain functions are represented by opaque
+// nodes. Optimization passes transform these nodes into new ones, and
+// compile() turns the result back into a module.
+//
+//     FloatModule optimized = graph::optimize(module);
+namespace tarragon::noise::graph
+{
+    enum class NodeType
+    {
+        Opaque,
+        Abs,
+        Add,
+        Billow,
+        Blend,
+        Cache,
+        Cell,
+        Checkerboard,
+        Clamp,
+        Constant,
+        Curve,
+        Cylinders,
+        Displace,
+        Exponent,
+        Invert,
+        Max,
+        Min,
+        Multiply,
+        Perlin,
+        Power,
+        RidgedMulti,
+        Rotate,
+        ScaleBias,
+        ScalePoint,
+        Select,
+        Spheres,
+        Terrace,
+        TranslatePoint,
+        Turbulence,
+        White,
+
+        // Scales, then moves the input position (Parameters: scale xyz, translation xyz).
+        // Only created by merge_affine, there is no factory for it.
+        AffinePoint,
+    };
+
+    // A node of a noise graph
+    //
+    // Parameters are the arguments of the factory function in declaration
+    // order, converted to double. Control point arrays are flattened, after
+    // the other parameters.
+    template <typename T>
+    struct Node
+    {
+        NodeType Type;
+        std::vector<double> Parameters;
+        std::vector<std::shared_ptr<Node const>> Sources;
+
+        // The module an opaque node stands for
+        BasicModule<T> Module;
+    };
+
+    template <typename T>
+    using NodePtr = std::shared_ptr<Node<T> const>;
+
+    // Gets the node describing a module
+    template <typename T>
+    NodePtr<T> from_module(BasicModule<T> const& module);
+
+    // Gets the range that the output values of a node provably lie in.
+    // Unknown bounds are infinite.
+    template <typename T>
+    Interval<T> value_range(NodePtr<T> const& pnode);
+
+    // Gets the range that the output values of a node provably lie in for
+    // the positions in a box. The smaller the box, the tighter the range
+    // of the generator nodes, e.g. a chunk whose range lies entirely on
+    // one side of a threshold doesn't need to be sampled.
+    template <typename T>
+    Interval<T> value_range(NodePtr<T> const& pnode, Box<T> const& box);
+
+    // Replaces subgraphs that don't depend on the input position by constants
+    template <typename T>
+    NodePtr<T> fold_constants(NodePtr<T> const& pnode);
+
+    // Merges chains of ScaleBias nodes into one ScaleBias, and chains of
+    // ScalePoint and TranslatePoint nodes into one affine transform.
+    // Transforms that do nothing are removed.
+    //
+    // This reassociates floating-point operations, so output values can
+    // differ from those of the original graph in the last bits.
+    template <typename T>
+    NodePtr<T> merge_affine(NodePtr<T> const& pnode);
+
+    // Replaces Select nodes by one of their sources if the value range of
+    // their control node shows that the other source is never selected
+    template <typename T>
+    NodePtr<T> eliminate_dead_branches(NodePtr<T> const& pnode);
+
+    // Merges identical subgraphs into one, so that each is evaluated only
+    // once per batch by the compiled module
+    template <typename T>
+    NodePtr<T> eliminate_common_subgraphs(NodePtr<T> const& pnode);
+
+    // Runs all of the passes above
+    template <typename T>
+    NodePtr<T> optimize(NodePtr<T> const& pnode);
+
+    // Creates a module that evaluates a graph.
+    //
+    // Batch evaluation computes nodes with more than one parent once per
+    // set of positions, instead of once per parent.
+    template <typename T>
+    BasicModule<T> compile(NodePtr<T> const& pnode);
+
+    // Optimizes and recompiles the graph of a module
+    template <typename T>
+    BasicModule<T> optimize(BasicModule<T> const& module)
+    {
+        return compile(optimize(from_module(module)));
+    }
+}
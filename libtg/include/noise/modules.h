@@ -1,16 +1,126 @@
 #pragma once
 
 #include <cstdint>
+#include <concepts>
 #include <functional>
+#include <memory>
+#include <span>
+#include <type_traits>
 
 #include <glm/vec3.hpp>
 #include <glm/gtc/constants.hpp>
+#include <glm/gtx/std_based_type.hpp>
 
 #include "noise/common.h"
 
 namespace tarragon::noise
 {
-    using Module = std::function<double(glm::dvec3)>;
+    namespace graph
+    {
+        template <typename T>
+        struct Node;
+    }
+
+    // A regular three-dimensional grid of sample positions
+    //
+    // The position of the sample at index {x, y, z} is Origin + {x, y, z} * Step.
+    // Samples are laid out with x varying fastest, then y, then z.
+    struct Grid
+    {
+        glm::dvec3 Origin;
+        glm::dvec3 Step;
+        glm::size3 Dims;
+
+        constexpr size_t count() const noexcept { return Dims.x * Dims.y * Dims.z; }
+    };
+
+    // A noise module, mapping input positions to output values
+    //
+    // Modules can be evaluated one position at a time, or for a whole batch
+    // of positions at once. Every built-in module implements batch evaluation
+    // natively, so that evaluating a graph for a block of positions costs one
+    // call per module instead of one call per module and position.
+    //
+    // T is the precision that positions and output values are computed in.
+    // A graph is built in one precision: Module (double) or FloatModule (float).
+    // Generator modules take the precision as template argument, e.g.
+    // Perlin<float>(), all other modules use the precision of their sources.
+    // Float graphs evaluate twice as many positions per SIMD instruction, but
+    // lose precision far from the origin.
+    //
+    // Modules are cheap to copy; copies share the same underlying functions.
+    //
+    // Modules created by the factory functions below are described by a
+    // graph node (see graph.h), which allows optimizing the graph.
+    template <typename T>
+    class BasicModule final
+    {
+    public:
+        using value_type = T;
+        using Position = glm::vec<3, T>;
+        using Function = std::function<T(Position)>;
+        using BatchFunction = std::function<void(std::span<Position const>, std::span<T>)>;
+
+    private:
+        struct Functions
+        {
+            Function Scalar;
+            BatchFunction Batch;
+        };
+
+        std::shared_ptr<Functions const> m_pfunctions;
+        std::shared_ptr<graph::Node<T> const> m_pnode;
+
+    public:
+        BasicModule() = default;
+
+        // Creates a module from a function and a batch function that
+        // must produce the same output values
+        BasicModule(Function function, BatchFunction batch_function);
+
+        // Creates a module from a function only. Batches are evaluated by
+        // calling the function for each position.
+        template <typename F>
+            requires (!std::same_as<std::remove_cvref_t<F>, BasicModule> && std::is_invocable_r_v<T, F const&, Position>)
+        BasicModule(F function)
+            : BasicModule{ Function{ function }, [function](std::span<Position const> positions, std::span<T> values)
+                {
+                    for (size_t i = 0; i < positions.size(); i++)
+                        values[i] = function(positions[i]);
+                } }
+        { }
+
+        explicit operator bool() const noexcept { return m_pfunctions != nullptr; }
+
+        // Modules are equal if they share the same functions
+        bool operator==(BasicModule const& other) const noexcept { return m_pfunctions == other.m_pfunctions; }
+
+        // Gets the graph node describing this module, or null if the module
+        // was created from a function
+        std::shared_ptr<graph::Node<T> const> const& node() const noexcept { return m_pnode; }
+
+        // Returns a copy of this module that is described by the given node
+        BasicModule with_node(std::shared_ptr<graph::Node<T> const> pnode) const
+        {
+            BasicModule module{ *this };
+            module.m_pnode = std::move(pnode);
+            return module;
+        }
+
+        // Gets the output value for a single position
+        T operator()(Position const& pos) const { return m_pfunctions->Scalar(pos); }
+
+        // Gets the output values for a batch of positions.
+        // values must hold at least as many elements as positions.
+        void operator()(std::span<Position const> positions, std::span<T> values) const;
+
+        // Gets the output values for every position on a grid.
+        // values must hold at least grid.count() elements.
+        void operator()(Grid const& grid, std::span<T> values) const;
+    };
+
+    using Module = BasicModule<double>;
+    using FloatModule = BasicModule<float>;
 
     enum class CellType
     {
@@ -90,10 +200,12 @@ namespace tarragon::noise
     constexpr uint32_t WhiteDefaultScale = 256;
 
     // Outputs the absolute value of the source value
-    Module Abs(Module source);
+    template <typename T>
+    BasicModule<T> Abs(BasicModule<T> source);
 
     // Outputs the sum of the source values
-    Module Add(Module source0, Module source1);
+    template <typename T>
+    BasicModule<T> Add(BasicModule<T> source0, BasicModule<T> source1);
 
     // Generates "billowy" noise suitable for clouds and rocks
     //
@@ -121,7 +233,8 @@ namespace tarragon::noise
     //
     // seed:
     //     The seed value used by the billowy-noise function
-    Module Billow(
+    template <typename T = double>
+    BasicModule<T> Billow(
         double frequency = BillowDefaultFrequency,
         double lacunarity = BillowDefaultLacunarity,
         uint32_t octave_count = BillowDefaultOctaveCount,
@@ -137,25 +250,32 @@ namespace tarragon::noise
     // Negative values weigh the blend towards the output of source0.
     // Positive values weigh the blend towards the output of source1.
     // This module uses linear interpolation to perform the blending.
-    Module Blend(Module source0, Module source1, Module control);
+    template <typename T>
+    BasicModule<T> Blend(BasicModule<T> source0, BasicModule<T> source1, BasicModule<T> control);
     
-    // Caches the last output value generated by its source (per thread)
+    // Caches the last output values generated by its source
+    //
+    // Each Cache module keeps its own cache per thread, holding the last
+    // output value for a single position and the last batch of output
+    // values.
     //
-    // If an application passes an input position that differs from the
-    // previously passed-in input value, this noise module instructs
-    // the source module to calculate the output value. This value,
-    // as well as the input position, are cached in this noise module.
+    // If an application passes an input position (or a batch of input
+    // positions) that differs from the previously passed one, this noise
+    // module instructs the source module to calculate the output values.
+    // These values, as well as the input positions, are cached in this
+    // noise module.
     //
-    // If the application passes an input position that is equal to
-    // the previously passed-in input value, this noise module
-    // returns the cached output value without having the source
-    // module recalculate the output value.
+    // If the application passes the same input position (or batch of input
+    // positions) as before, this noise module returns the cached output
+    // values without having the source module recalculate them.
     //
     // Caching a noise module is useful if it is used as a source module for
     // multiple noise modules. If a source module is not cached, the source
-    // module will redundantly calculate the same output value once for each
-    // noise module in which it is included.
-    Module Cache(Module source);
+    // module will redundantly calculate the same output values once for each
+    // noise module in which it is included. With batch evaluation, a cached
+    // subgraph is evaluated once per block of positions.
+    template <typename T>
+    BasicModule<T> Cache(BasicModule<T> source);
     
     // Outputs cell noise
     //
@@ -206,7 +326,8 @@ namespace tarragon::noise
     //
     // seed:
     //     The seed value used by the Cell generator
-    Module Cell(
+    template <typename T = double>
+    BasicModule<T> Cell(
         CellType type = CellDefaultType,
         double displacement = CellDefaultDisplacement,
         double frequency = CellDefaultFrequency,
@@ -219,7 +340,8 @@ namespace tarragon::noise
     // This noise module outputs unit-sized blocks of alternating values.
     // The values of these blocks alternate between -1.0 and +1.0.
     // Sometimes useful for debugging purposes.
-    Module Checkerboard();
+    template <typename T = double>
+    BasicModule<T> Checkerboard();
 
     // Outputs source values clamped into a range
     //
@@ -230,15 +352,17 @@ namespace tarragon::noise
     // the lower bound. If the output value from the source module is
     // greater than the upper bound of the clamping range, this noise module
     // clamps that value to the upper bound.
-    Module Clamp(
-        Module source,
+    template <typename T>
+    BasicModule<T> Clamp(
+        BasicModule<T> source,
         double lower_bound = ClampDefaultLowerBound,
         double upper_bound = ClampDefaultUpperBound);
 
     // Outputs a constant value
     //
     // Not really useful by itself, but often used as a source module.
-    Module Constant(double value = ConstantDefaultValue);
+    template <typename T = double>
+    BasicModule<T> Constant(double value = ConstantDefaultValue);
 
     // Maps the output value from a source module onto an
     // arbitrary function curve created by the given control points
@@ -262,7 +386,8 @@ namespace tarragon::noise
     //
     // control_point_count:
     //     Number of control points to copy from the given array
-    Module Curve(Module source, ControlPoint const *control_points, size_t control_point_count);
+    template <typename T>
+    BasicModule<T> Curve(BasicModule<T> source, ControlPoint const *control_points, size_t control_point_count);
 
     // Outputs concentric cylinders
     //
@@ -290,7 +415,8 @@ namespace tarragon::noise
     //     The frequency of the concentric cylinders.
     //     Increasing the frequency increases the density of the concentric
     //     cylinders, reducing the distances between them.
-    Module Cylinders(double frequency = CylindersDefaultFrequency);
+    template <typename T = double>
+    BasicModule<T> Cylinders(double frequency = CylindersDefaultFrequency);
 
     // Uses three source modules to displace each coordinate 
     // of the input value before returning the output value from
@@ -303,11 +429,12 @@ namespace tarragon::noise
     // The Turbulence noise module is a special case of the
     // displacement module; internally, there are three Perlin-noise modules
     // that perform the displacement operation.
-    Module Displace(
-        Module source,
-        Module xdisplace,
-        Module ydisplace,
-        Module zdisplace);
+    template <typename T>
+    BasicModule<T> Displace(
+        BasicModule<T> source,
+        BasicModule<T> xdisplace,
+        BasicModule<T> ydisplace,
+        BasicModule<T> zdisplace);
 
     // Maps the output value from a source module onto an exponential curve
     //
@@ -319,19 +446,24 @@ namespace tarragon::noise
     // exponent:
     //     The exponent value to apply to the output value from the
     //     source module.
-    Module Exponent(Module source, double exponent = ExponentDefaultExponent);
+    template <typename T>
+    BasicModule<T> Exponent(BasicModule<T> source, double exponent = ExponentDefaultExponent);
 
     // Inverts the output value from a source module
-    Module Invert(Module source);
+    template <typename T>
+    BasicModule<T> Invert(BasicModule<T> source);
 
     // Outputs the larger of the two output values from two source modules
-    Module Max(Module source0, Module source1);
+    template <typename T>
+    BasicModule<T> Max(BasicModule<T> source0, BasicModule<T> source1);
 
     // Outputs the smaller of the two output values from two source modules
-    Module Min(Module source0, Module source1);
+    template <typename T>
+    BasicModule<T> Min(BasicModule<T> source0, BasicModule<T> source1);
 
     // Outputs the product of the two output values from two source modules
-    Module Multiply(Module source0, Module source1);
+    template <typename T>
+    BasicModule<T> Multiply(BasicModule<T> source0, BasicModule<T> source1);
 
     // Outputs 3-dimensional Perlin noise
     //
@@ -393,7 +525,8 @@ namespace tarragon::noise
     //
     // seed:
     //     The seed value used by the Perlin-noise function
-    Module Perlin(
+    template <typename T = double>
+    BasicModule<T> Perlin(
         double frequency = PerlinDefaultFrequency,
         double lacunarity = PerlinDefaultLacunarity,
         uint32_t octave_count = PerlinDefaultOctaveCount,
@@ -403,7 +536,8 @@ namespace tarragon::noise
     
     // Raises the output value from a first source module
     // to the power of the output value from a second source module
-    Module Power(Module source0, Module source1);
+    template <typename T>
+    BasicModule<T> Power(BasicModule<T> source0, BasicModule<T> source1);
 
     // Outputs 3-dimensional ridged-multifractal noise
     //
@@ -449,7 +583,8 @@ namespace tarragon::noise
     //
     // seed:
     //     The seed value used by the Perlin-noise function
-    Module RidgedMulti(
+    template <typename T = double>
+    BasicModule<T> RidgedMulti(
         double frequency = RidgedMultiDefaultFrequency,
         double lacunarity = RidgedMultiDefaultLacunarity,
         uint32_t octave_count = RidgedMultiDefaultOctaveCount,
@@ -458,22 +593,25 @@ namespace tarragon::noise
 
     // Rotates the input value around the origin before
     // returning the output value from a source module
-    Module Rotate(
-        Module source,
+    template <typename T>
+    BasicModule<T> Rotate(
+        BasicModule<T> source,
         double xdegrees = RotateDefaultAngle,
         double ydegrees = RotateDefaultAngle,
         double zdegrees = RotateDefaultAngle);
     
     // Applies a scaling factor and a bias to the output value from a source module
-    Module ScaleBias(
-        Module source,
+    template <typename T>
+    BasicModule<T> ScaleBias(
+        BasicModule<T> source,
         double scale = ScaleBiasDefaultScale,
         double bias = ScaleBiasDefaultBias);
 
     // Scales the coordinates of the input value before
     // returning the output value from a source module
-    Module ScalePoint(
-        Module source,
+    template <typename T>
+    BasicModule<T> ScalePoint(
+        BasicModule<T> source,
         glm::dvec3 const& scale_factor = ScalePointDefaultScaleFactor);
 
     // Outputs the value selected from one of two source
@@ -520,17 +658,19 @@ namespace tarragon::noise
     //         0.7 (= 0.8 - 0.1) and 0.9 (= 0.8 + 0.1).
     //       - the output value from source0  if the output value from the control
     //         module is greater than 0.9 (= 0.8 + 0.1).
-    Module Select(
-        Module source0,
-        Module source1,
-        Module control,
+    template <typename T>
+    BasicModule<T> Select(
+        BasicModule<T> source0,
+        BasicModule<T> source1,
+        BasicModule<T> control,
         double lower_bound = SelectDefaultLowerBound,
         double upper_bound = SelectDefaultUpperBound,
         double edge_falloff = SelectDefaultEdgeFalloff);
 
     // TODO
     // Outputs 3-dimensional Simplex noise
-    Module Simplex(
+    template <typename T = double>
+    BasicModule<T> Simplex(
         double frequency = SimplexDefaultFrequency,
         double lacunarity = SimplexDefaultLacunarity,
         uint32_t octave_count = SimplexDefaultOctaveCount,
@@ -554,7 +694,8 @@ namespace tarragon::noise
     //
     // This noise module, modified with some low-frequency, low-power
     // turbulence, is useful for generating agate-like textures.
-    Module Spheres(double frequency = SpheresDefaultFrequency);
+    template <typename T = double>
+    BasicModule<T> Spheres(double frequency = SpheresDefaultFrequency);
 
     // Maps the output value from a source module onto a terrace-forming curve
     //
@@ -588,16 +729,18 @@ namespace tarragon::noise
     // invert_terraces:
     //     Enables or disables the inversion of the terrace-forming curve
     //     between the control points.
-    Module Terrace(
-        Module source,
+    template <typename T>
+    BasicModule<T> Terrace(
+        BasicModule<T> source,
         double const *control_points,
         size_t control_point_count,
         bool invert_terraces = TerraceDefaultInvertTerraces);
 
     // Moves the coordinates of the input value before
     // returning the output value from a source module
-    Module TranslatePoint(
-        Module source,
+    template <typename T>
+    BasicModule<T> TranslatePoint(
+        BasicModule<T> source,
         glm::dvec3 const& translation = TranslateDefaultTranslation);
 
     // Randomly displaces the input value before
@@ -651,15 +794,17 @@ namespace tarragon::noise
     // seed:
     //     The seed value of the three internal Perlin-noise modules that
     //     are used to displace each coordinate of the input position.
-    Module Turbulence(
-        Module source,
+    template <typename T>
+    BasicModule<T> Turbulence(
+        BasicModule<T> source,
         double frequency = TurbulenceDefaultFrequency,
         double power = TurbulenceDefaultPower,
         uint32_t roughness = TurbulenceDefaultRoughness,
         int32_t seed = DefaultSeed);
 
     // Outputs 3-dimensional White noise
-    Module White(
+    template <typename T = double>
+    BasicModule<T> White(
         int32_t scale = WhiteDefaultScale,
         int32_t seed = DefaultSeed);
 }
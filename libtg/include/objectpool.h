@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace tarragon
+{
+    // Objects that keep their address until they are destroyed
+    //
+    // Objects are constructed in blocks of BlockSize slots, which are only
+    // freed with the pool, so creating an object pops a free slot or takes
+    // the next one of the last block instead of allocating, and objects
+    // created together lie close together in memory. The slots of
+    // destroyed objects are reused, most recently destroyed first.
+    template <typename T, size_t BlockSize = 256>
+    class ObjectPool final
+    {
+        static_assert(BlockSize > 0, "Blocks can't be empty.");
+
+    private:
+        union Slot
+        {
+            T Value;
+            Slot* pNextFree;
+
+            Slot() noexcept : pNextFree{} { }
+            ~Slot() { }
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> m_blocks;
+        // Slots of the last block that were never used
+        size_t m_unused{};
+        Slot* m_pfree{};
+        size_t m_size{};
+
+    public:
+        ObjectPool() = default;
+
+        ObjectPool(ObjectPool const&) = delete;
+        ObjectPool& operator= (ObjectPool const&) = delete;
+
+        // Destroys the objects that are still alive
+        ~ObjectPool()
+        {
+            if (m_size == 0)
+                return;
+
+            // The free slots hold links instead of objects
+            std::vector<Slot const*> free_slots{};
+            for (auto pslot = m_pfree; pslot != nullptr; pslot = pslot->pNextFree)
+                free_slots.push_back(pslot);
+            std::sort(std::begin(free_slots), std::end(free_slots), std::less<>{});
+
+            for (size_t block = 0; block < m_blocks.size(); block++)
+            {
+                auto used = block + 1 == m_blocks.size() ? BlockSize - m_unused : BlockSize;
+                for (size_t i = 0; i < used; i++)
+                {
+                    auto pslot = &m_blocks[block][i];
+                    if (!std::binary_search(std::begin(free_slots), std::end(free_slots), pslot, std::less<>{}))
+                        std::destroy_at(&pslot->Value);
+                }
+            }
+        }
+
+        // Number of live objects
+        size_t size() const noexcept { return m_size; }
+        // Number of slots, live or free
+        size_t capacity() const noexcept { return m_blocks.size() * BlockSize; }
+
+        template <typename... Args>
+        T* create(Args&&... args)
+        {
+            Slot* pslot{};
+            if (m_pfree != nullptr)
+            {
+                pslot = m_pfree;
+                m_pfree = pslot->pNextFree;
+            }
+            else
+            {
+                if (m_unused == 0)
+                {
+                    m_blocks.push_back(std::make_unique<Slot[]>(BlockSize));
+                    m_unused = BlockSize;
+                }
+                pslot = &m_blocks.back()[BlockSize - m_unused];
+                m_unused--;
+            }
+
+            // Hand the slot back if the constructor throws
+            try
+            {
+                std::construct_at(&pslot->Value, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                pslot->pNextFree = m_pfree;
+                m_pfree = pslot;
+                throw;
+            }
+            m_size++;
+            return &pslot->Value;
+        }
+
+        // Destroys an object created by this pool
+        void destroy(T* pvalue)
+        {
+            assert(pvalue != nullptr && m_size > 0);
+
+            // A union and its members share their address
+            auto pslot = reinterpret_cast<Slot*>(pvalue);
+            std::destroy_at(pvalue);
+            std::construct_at(&pslot->pNextFree, m_pfree);
+            m_pfree = pslot;
+            m_size--;
+        }
+    };
+}
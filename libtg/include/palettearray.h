@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace tarragon
+{
+    // A fixed number of values, stored as indices into a palette of the
+    // distinct values
+    //
+    // While every element holds the same value, only that value is stored
+    // and nothing is allocated. Otherwise the indices are packed into 64-bit
+    // words with 1, 2, 4, 8 or 16 bits each, the fewest that can address the
+    // palette, so elements never straddle two words. Setting a value that is
+    // not in the palette yet widens the indices when the palette is full.
+    //
+    // Values that are overwritten stay in the palette until compact().
+    // T is compared with ==, palettes are expected to be small.
+    template <typename T, size_t Size>
+    class PaletteArray final
+    {
+        static_assert(Size > 0, "Palette array can't be empty.");
+
+    public:
+        static constexpr unsigned MaxBits = 16;
+
+    private:
+        static constexpr unsigned WordBits = 64;
+
+        // The value of all elements while uniform
+        T m_uniform{};
+        // Bits per index, 0 while uniform
+        unsigned m_bits{};
+        std::vector<T> m_palette;
+        std::vector<uint64_t> m_words;
+
+        static constexpr size_t word_count(unsigned bits) noexcept
+        {
+            return (Size * bits + WordBits - 1) / WordBits;
+        }
+
+        size_t index_at(size_t i) const noexcept
+        {
+            auto bit = i * m_bits;
+            auto mask = (uint64_t{ 1 } << m_bits) - 1;
+            return static_cast<size_t>((m_words[bit / WordBits] >> (bit % WordBits)) & mask);
+        }
+
+        void set_index_at(size_t i, size_t index) noexcept
+        {
+            auto bit = i * m_bits;
+            auto mask = (uint64_t{ 1 } << m_bits) - 1;
+            auto& word = m_words[bit / WordBits];
+            word = (word & ~(mask << (bit % WordBits))) | (static_cast<uint64_t>(index) << (bit % WordBits));
+        }
+
+        // Repacks the indices with the given number of bits, remapping
+        // each of them through remap
+        template <typename F>
+        void repack(unsigned bits, F&& remap)
+        {
+            assert(m_bits > 0 && bits > 0 && bits <= MaxBits);
+
+            std::vector<uint64_t> words(word_count(bits));
+            auto mask = (uint64_t{ 1 } << bits) - 1;
+            for (size_t i = 0; i < Size; i++)
+            {
+                auto index = static_cast<uint64_t>(remap(index_at(i))) & mask;
+                auto bit = i * bits;
+                words[bit / WordBits] |= index << (bit % WordBits);
+            }
+
+            m_words = std::move(words);
+            m_bits = bits;
+        }
+
+    public:
+        PaletteArray() = default;
+
+        explicit PaletteArray(T const& value)
+            : m_uniform{ value }
+        { }
+
+        static constexpr size_t size() noexcept { return Size; }
+
+        bool is_uniform() const noexcept { return m_bits == 0; }
+        unsigned bits() const noexcept { return m_bits; }
+        // Number of distinct values, including overwritten ones until compact()
+        size_t palette_size() const noexcept { return is_uniform() ? 1 : m_palette.size(); }
+
+        // Bytes allocated for the palette and indices
+        size_t heap_size() const noexcept
+        {
+            return m_palette.capacity() * sizeof(T) + m_words.capacity() * sizeof(uint64_t);
+        }
+
+        T const& at(size_t i) const noexcept
+        {
+            assert(i < Size);
+            return is_uniform() ? m_uniform : m_palette[index_at(i)];
+        }
+
+        void set_at(size_t i, T const& value)
+        {
+            assert(i < Size);
+
+            if (is_uniform())
+            {
+                if (value == m_uniform)
+                    return;
+
+                // All elements keep index 0, the former uniform value
+                m_palette = { m_uniform, value };
+                m_words.assign(word_count(1), 0);
+                m_bits = 1;
+                set_index_at(i, 1);
+                return;
+            }
+
+            auto it = std::find(std::begin(m_palette), std::end(m_palette), value);
+            auto index = static_cast<size_t>(it - std::begin(m_palette));
+            if (it == std::end(m_palette))
+            {
+                if (index == (size_t{ 1 } << m_bits))
+                {
+                    assert(m_bits < MaxBits);
+                    repack(m_bits * 2, [](size_t index) { return index; });
+                }
+                m_palette.push_back(value);
+            }
+            set_index_at(i, index);
+        }
+
+        // Sets every element to value and frees the palette and indices
+        void fill(T const& value)
+        {
+            m_uniform = value;
+            m_bits = 0;
+            // Assigning {} would keep the allocations
+            m_palette = std::vector<T>{};
+            m_words = std::vector<uint64_t>{};
+        }
+
+        // Drops the values no element holds any more and narrows the
+        // indices, going back to a single uniform value if only one is left
+        void compact()
+        {
+            if (is_uniform())
+                return;
+
+            std::vector<uint8_t> used(m_palette.size());
+            for (size_t i = 0; i < Size; i++)
+                used[index_at(i)] = 1;
+
+            std::vector<size_t> remap(m_palette.size());
+            std::vector<T> palette;
+            for (size_t index = 0; index < m_palette.size(); index++)
+            {
+                if (!used[index])
+                    continue;
+                remap[index] = palette.size();
+                palette.push_back(std::move(m_palette[index]));
+            }
+
+            if (palette.size() == 1)
+            {
+                fill(palette.front());
+                return;
+            }
+
+            unsigned bits = 1;
+            while ((size_t{ 1 } << bits) < palette.size())
+                bits *= 2;
+
+            repack(bits, [&](size_t index) { return remap[index]; });
+            m_palette = std::move(palette);
+            m_palette.shrink_to_fit();
+        }
+    };
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <optional>
+
+namespace tarragon
+{
+    // Hands out ranges of [0, capacity), e.g. of elements in a GPU buffer
+    //
+    // Free ranges are kept in two maps, by offset to merge a freed range with
+    // its free neighbours, and by size to find the smallest free range that
+    // fits an allocation. Allocating and freeing take O(log n) in the number
+    // of free ranges. Merging keeps fragmentation in check; the allocator
+    // can't move allocated ranges, but it can grow.
+    class RangeAllocator final
+    {
+    private:
+        std::map<size_t, size_t> m_free_by_offset;
+        std::multimap<size_t, size_t> m_free_by_size;
+        size_t m_capacity;
+        size_t m_allocated{};
+
+        void insert_free(size_t offset, size_t size);
+        void erase_free(std::map<size_t, size_t>::iterator it);
+
+    public:
+        explicit RangeAllocator(size_t capacity);
+
+        // Returns the offset of size free elements, or nothing if no free
+        // range is large enough
+        std::optional<size_t> allocate(size_t size);
+        // Returns a range returned by allocate to the free ranges
+        void free(size_t offset, size_t size);
+
+        // Adds the elements up to capacity to the free ranges
+        void grow(size_t capacity);
+
+        size_t capacity() const noexcept { return m_capacity; }
+        size_t allocated() const noexcept { return m_allocated; }
+        size_t free_range_count() const noexcept { return m_free_by_offset.size(); }
+        size_t largest_free_range() const noexcept { return m_free_by_size.empty() ? 0 : std::prev(m_free_by_size.end())->first; }
+    };
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tarragon
+{
+    // Values addressed by handles that stay valid until their value is erased
+    //
+    // Values are stored contiguously, so iterating them is a linear walk.
+    // Erasing moves the last value into the hole, so inserting, erasing and
+    // looking up a handle all take constant time, but erasing changes the
+    // order of the values. Each handle carries the generation of its slot,
+    // which is bumped when the value is erased, so stale handles are
+    // detected instead of addressing a newer value.
+    template <typename T>
+    class SlotMap final
+    {
+    public:
+        struct Handle
+        {
+            uint32_t Index;
+            uint32_t Generation;
+
+            friend bool operator==(Handle const&, Handle const&) = default;
+        };
+
+    private:
+        struct Slot
+        {
+            // Position of the value in m_values, if the slot is used
+            uint32_t ValueIndex;
+            uint32_t Generation;
+        };
+
+        std::vector<T> m_values;
+        // The slot of each value, to fix up the slot of a moved value
+        std::vector<uint32_t> m_value_slots;
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_free_slots;
+
+    public:
+        size_t size() const noexcept { return m_values.size(); }
+        bool empty() const noexcept { return m_values.empty(); }
+
+        Handle insert(T value)
+        {
+            uint32_t slot_index{};
+            if (m_free_slots.empty())
+            {
+                slot_index = static_cast<uint32_t>(m_slots.size());
+                m_slots.push_back({ 0, 0 });
+            }
+            else
+            {
+                slot_index = m_free_slots.back();
+                m_free_slots.pop_back();
+            }
+
+            auto& slot = m_slots[slot_index];
+            slot.ValueIndex = static_cast<uint32_t>(m_values.size());
+            m_values.push_back(std::move(value));
+            m_value_slots.push_back(slot_index);
+            return Handle{ slot_index, slot.Generation };
+        }
+
+        bool contains(Handle handle) const noexcept
+        {
+            // Freed slots have moved on to the next generation
+            return handle.Index < m_slots.size() && m_slots[handle.Index].Generation == handle.Generation;
+        }
+
+        T* get(Handle handle) noexcept
+        {
+            return contains(handle) ? &m_values[m_slots[handle.Index].ValueIndex] : nullptr;
+        }
+
+        T const* get(Handle handle) const noexcept
+        {
+            return contains(handle) ? &m_values[m_slots[handle.Index].ValueIndex] : nullptr;
+        }
+
+        // Returns false if the handle is stale
+        bool erase(Handle handle)
+        {
+            if (!contains(handle))
+                return false;
+
+            auto& slot = m_slots[handle.Index];
+            auto value_index = slot.ValueIndex;
+            if (value_index != m_values.size() - 1)
+            {
+                m_values[value_index] = std::move(m_values.back());
+                m_value_slots[value_index] = m_value_slots.back();
+                m_slots[m_value_slots[value_index]].ValueIndex = value_index;
+            }
+            m_values.pop_back();
+            m_value_slots.pop_back();
+
+            slot.Generation++;
+            m_free_slots.push_back(handle.Index);
+            return true;
+        }
+
+        void clear()
+        {
+            for (auto slot_index : m_value_slots)
+            {
+                m_slots[slot_index].Generation++;
+                m_free_slots.push_back(slot_index);
+            }
+            m_values.clear();
+            m_value_slots.clear();
+        }
+
+        std::span<T> values() noexcept { return m_values; }
+        std::span<T const> values() const noexcept { return m_values; }
+
+        auto begin() noexcept { return m_values.begin(); }
+        auto end() noexcept { return m_values.end(); }
+        auto begin() const noexcept { return m_values.begin(); }
+        auto end() const noexcept { return m_values.end(); }
+    };
+}
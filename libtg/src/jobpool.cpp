@@ -0,0 +1,108 @@
+#include "jobpool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tarragon
+{
+    namespace
+    {
+        // The pool and index of the worker running on this thread, if any
+        thread_local JobPool* t_ppool{};
+        thread_local size_t t_worker_index{};
+    }
+
+    size_t JobPool::default_worker_count() noexcept
+    {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    JobPool::JobPool(size_t worker_count)
+    {
+        assert(worker_count > 0);
+
+        for (size_t i = 0; i < worker_count; i++)
+            m_workers.push_back(std::make_unique<Worker>());
+
+        // Start the threads only once all deques exist, they steal from each other.
+        for (size_t i = 0; i < worker_count; i++)
+            m_threads.emplace_back([this, i](std::stop_token stop_token) { worker_loop(stop_token, i); });
+    }
+
+    JobPool::~JobPool()
+    {
+        for (auto& thread : m_threads)
+            thread.request_stop();
+        m_threads.clear();
+    }
+
+    void JobPool::submit(Job job)
+    {
+        auto index = t_ppool == this
+            ? t_worker_index
+            : m_next_worker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+        {
+            std::lock_guard g{ m_wake_mtx };
+            m_queued_count++;
+        }
+
+        {
+            auto& worker = *m_workers.at(index);
+            std::lock_guard g{ worker.Mutex };
+            worker.Jobs.push_back(std::move(job));
+        }
+
+        m_wake_cv.notify_one();
+    }
+
+    bool JobPool::try_pop(size_t index, Job& job)
+    {
+        // Newest job of this worker first
+        {
+            auto& worker = *m_workers.at(index);
+            std::lock_guard g{ worker.Mutex };
+            if (!worker.Jobs.empty())
+            {
+                job = std::move(worker.Jobs.back());
+                worker.Jobs.pop_back();
+                return true;
+            }
+        }
+
+        // Then the oldest job of any other worker
+        for (size_t i = 1; i < m_workers.size(); i++)
+        {
+            auto& victim = *m_workers.at((index + i) % m_workers.size());
+            std::lock_guard g{ victim.Mutex };
+            if (!victim.Jobs.empty())
+            {
+                job = std::move(victim.Jobs.front());
+                victim.Jobs.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void JobPool::worker_loop(std::stop_token stop_token, size_t index)
+    {
+        t_ppool = this;
+        t_worker_index = index;
+
+        while (!stop_token.stop_requested())
+        {
+            Job job{};
+            if (try_pop(index, job))
+            {
+                m_queued_count--;
+                job();
+                continue;
+            }
+
+            std::unique_lock lock{ m_wake_mtx };
+            m_wake_cv.wait(lock, stop_token, [this] { return m_queued_count > 0; });
+        }
+    }
+}
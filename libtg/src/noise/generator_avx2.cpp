@@ -0,0 +1,208 @@
+#include "simd.h"
+
+#if TARRAGON_NOISE_X86
+
+#include <immintrin.h>
+
+#include "tables.h"
+
+namespace tarragon::noise::simd
+{
+    namespace
+    {
+        constexpr size_t DoubleLanes = 4;
+        constexpr size_t FloatLanes = 8;
+
+        // Rounds towards negative infinity like the scalar generator, which
+        // also maps integral values <= 0 to the next lower integer.
+        __m128i floor_pos(__m256d pos)
+        {
+            auto not_positive = _mm256_cmp_pd(pos, _mm256_setzero_pd(), _CMP_NGT_UQ);
+            auto truncated = _mm256_cvttpd_epi32(pos);
+            auto correction = _mm256_cvttpd_epi32(_mm256_and_pd(not_positive, _mm256_set1_pd(1.0)));
+            return _mm_sub_epi32(truncated, correction);
+        }
+
+        __m256d scurve(__m256d a, NoiseQuality quality)
+        {
+            switch (quality)
+            {
+                case NoiseQuality::Fast:
+                    return a;
+                case NoiseQuality::Standard:
+                    return _mm256_mul_pd(_mm256_mul_pd(a, a), _mm256_sub_pd(_mm256_set1_pd(3.0), _mm256_mul_pd(_mm256_set1_pd(2.0), a)));
+                case NoiseQuality::Best:
+                {
+                    auto a3 = _mm256_mul_pd(_mm256_mul_pd(a, a), a);
+                    auto a4 = _mm256_mul_pd(a3, a);
+                    auto a5 = _mm256_mul_pd(a4, a);
+                    return _mm256_add_pd(
+                        _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(6.0), a5), _mm256_mul_pd(_mm256_set1_pd(15.0), a4)),
+                        _mm256_mul_pd(_mm256_set1_pd(10.0), a3));
+                }
+            }
+            return a;
+        }
+
+        // Same operation order as glm::mix
+        __m256d mix(__m256d x, __m256d y, __m256d a)
+        {
+            return _mm256_add_pd(_mm256_mul_pd(x, _mm256_sub_pd(_mm256_set1_pd(1.0), a)), _mm256_mul_pd(y, a));
+        }
+
+        __m256d gradient_noise(__m256d x, __m256d y, __m256d z, __m128i ix, __m128i iy, __m128i iz, __m128i seed_term)
+        {
+            auto vector_index = _mm_add_epi32(
+                _mm_add_epi32(
+                    _mm_add_epi32(_mm_mullo_epi32(ix, _mm_set1_epi32(NoiseGen.x)), _mm_mullo_epi32(iy, _mm_set1_epi32(NoiseGen.y))),
+                    _mm_mullo_epi32(iz, _mm_set1_epi32(NoiseGen.z))),
+                seed_term);
+            vector_index = _mm_xor_si128(vector_index, _mm_srai_epi32(vector_index, ShiftNoiseGen));
+            vector_index = _mm_and_si128(vector_index, _mm_set1_epi32(0xff));
+            vector_index = _mm_slli_epi32(vector_index, 2);
+
+            auto all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            auto xgrad = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), VectorTable.data(), vector_index, all, sizeof(double));
+            auto ygrad = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), VectorTable.data() + 1, vector_index, all, sizeof(double));
+            auto zgrad = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), VectorTable.data() + 2, vector_index, all, sizeof(double));
+
+            auto xpoint = _mm256_sub_pd(x, _mm256_cvtepi32_pd(ix));
+            auto ypoint = _mm256_sub_pd(y, _mm256_cvtepi32_pd(iy));
+            auto zpoint = _mm256_sub_pd(z, _mm256_cvtepi32_pd(iz));
+
+            auto dot = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(xgrad, xpoint), _mm256_mul_pd(ygrad, ypoint)),
+                _mm256_mul_pd(zgrad, zpoint));
+            return _mm256_mul_pd(dot, _mm256_set1_pd(2.12));
+        }
+
+        __m256i floor_pos(__m256 pos)
+        {
+            auto not_positive = _mm256_cmp_ps(pos, _mm256_setzero_ps(), _CMP_NGT_UQ);
+            auto truncated = _mm256_cvttps_epi32(pos);
+            auto correction = _mm256_cvttps_epi32(_mm256_and_ps(not_positive, _mm256_set1_ps(1.0f)));
+            return _mm256_sub_epi32(truncated, correction);
+        }
+
+        __m256 scurve(__m256 a, NoiseQuality quality)
+        {
+            switch (quality)
+            {
+                case NoiseQuality::Fast:
+                    return a;
+                case NoiseQuality::Standard:
+                    return _mm256_mul_ps(_mm256_mul_ps(a, a), _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), a)));
+                case NoiseQuality::Best:
+                {
+                    auto a3 = _mm256_mul_ps(_mm256_mul_ps(a, a), a);
+                    auto a4 = _mm256_mul_ps(a3, a);
+                    auto a5 = _mm256_mul_ps(a4, a);
+                    return _mm256_add_ps(
+                        _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(6.0f), a5), _mm256_mul_ps(_mm256_set1_ps(15.0f), a4)),
+                        _mm256_mul_ps(_mm256_set1_ps(10.0f), a3));
+                }
+            }
+            return a;
+        }
+
+        __m256 mix(__m256 x, __m256 y, __m256 a)
+        {
+            return _mm256_add_ps(_mm256_mul_ps(x, _mm256_sub_ps(_mm256_set1_ps(1.0f), a)), _mm256_mul_ps(y, a));
+        }
+
+        __m256 gradient_noise(__m256 x, __m256 y, __m256 z, __m256i ix, __m256i iy, __m256i iz, __m256i seed_term)
+        {
+            auto vector_index = _mm256_add_epi32(
+                _mm256_add_epi32(
+                    _mm256_add_epi32(_mm256_mullo_epi32(ix, _mm256_set1_epi32(NoiseGen.x)), _mm256_mullo_epi32(iy, _mm256_set1_epi32(NoiseGen.y))),
+                    _mm256_mullo_epi32(iz, _mm256_set1_epi32(NoiseGen.z))),
+                seed_term);
+            vector_index = _mm256_xor_si256(vector_index, _mm256_srai_epi32(vector_index, ShiftNoiseGen));
+            vector_index = _mm256_and_si256(vector_index, _mm256_set1_epi32(0xff));
+            vector_index = _mm256_slli_epi32(vector_index, 2);
+
+            auto const& vector_table = VectorTableOf<float>;
+            auto all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            auto xgrad = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), vector_table.data(), vector_index, all, sizeof(float));
+            auto ygrad = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), vector_table.data() + 1, vector_index, all, sizeof(float));
+            auto zgrad = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), vector_table.data() + 2, vector_index, all, sizeof(float));
+
+            auto xpoint = _mm256_sub_ps(x, _mm256_cvtepi32_ps(ix));
+            auto ypoint = _mm256_sub_ps(y, _mm256_cvtepi32_ps(iy));
+            auto zpoint = _mm256_sub_ps(z, _mm256_cvtepi32_ps(iz));
+
+            auto dot = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(xgrad, xpoint), _mm256_mul_ps(ygrad, ypoint)),
+                _mm256_mul_ps(zgrad, zpoint));
+            return _mm256_mul_ps(dot, _mm256_set1_ps(2.12f));
+        }
+    }
+
+    size_t gradient_coherent_noise_3d_avx2(std::span<glm::dvec3 const> positions, std::span<double> values, int32_t seed, NoiseQuality quality)
+    {
+        auto seed_term = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(SeedNoiseGen) * static_cast<uint32_t>(seed)));
+        auto one = _mm_set1_epi32(1);
+
+        size_t i{};
+        for (; i + DoubleLanes <= positions.size(); i += DoubleLanes)
+        {
+            auto const* p = positions.data() + i;
+            auto x = _mm256_setr_pd(p[0].x, p[1].x, p[2].x, p[3].x);
+            auto y = _mm256_setr_pd(p[0].y, p[1].y, p[2].y, p[3].y);
+            auto z = _mm256_setr_pd(p[0].z, p[1].z, p[2].z, p[3].z);
+
+            auto x0 = floor_pos(x), y0 = floor_pos(y), z0 = floor_pos(z);
+            auto x1 = _mm_add_epi32(x0, one), y1 = _mm_add_epi32(y0, one), z1 = _mm_add_epi32(z0, one);
+
+            auto xs = scurve(_mm256_sub_pd(x, _mm256_cvtepi32_pd(x0)), quality);
+            auto ys = scurve(_mm256_sub_pd(y, _mm256_cvtepi32_pd(y0)), quality);
+            auto zs = scurve(_mm256_sub_pd(z, _mm256_cvtepi32_pd(z0)), quality);
+
+            auto ix0 = mix(gradient_noise(x, y, z, x0, y0, z0, seed_term), gradient_noise(x, y, z, x1, y0, z0, seed_term), xs);
+            auto ix1 = mix(gradient_noise(x, y, z, x0, y1, z0, seed_term), gradient_noise(x, y, z, x1, y1, z0, seed_term), xs);
+            auto iy0 = mix(ix0, ix1, ys);
+            ix0 = mix(gradient_noise(x, y, z, x0, y0, z1, seed_term), gradient_noise(x, y, z, x1, y0, z1, seed_term), xs);
+            ix1 = mix(gradient_noise(x, y, z, x0, y1, z1, seed_term), gradient_noise(x, y, z, x1, y1, z1, seed_term), xs);
+            auto iy1 = mix(ix0, ix1, ys);
+
+            _mm256_storeu_pd(values.data() + i, mix(iy0, iy1, zs));
+        }
+
+        return i;
+    }
+
+    size_t gradient_coherent_noise_3d_avx2(std::span<glm::vec3 const> positions, std::span<float> values, int32_t seed, NoiseQuality quality)
+    {
+        auto seed_term = _mm256_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(SeedNoiseGen) * static_cast<uint32_t>(seed)));
+        auto one = _mm256_set1_epi32(1);
+
+        size_t i{};
+        for (; i + FloatLanes <= positions.size(); i += FloatLanes)
+        {
+            auto const* p = positions.data() + i;
+            auto x = _mm256_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x, p[4].x, p[5].x, p[6].x, p[7].x);
+            auto y = _mm256_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y, p[4].y, p[5].y, p[6].y, p[7].y);
+            auto z = _mm256_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z, p[4].z, p[5].z, p[6].z, p[7].z);
+
+            auto x0 = floor_pos(x), y0 = floor_pos(y), z0 = floor_pos(z);
+            auto x1 = _mm256_add_epi32(x0, one), y1 = _mm256_add_epi32(y0, one), z1 = _mm256_add_epi32(z0, one);
+
+            auto xs = scurve(_mm256_sub_ps(x, _mm256_cvtepi32_ps(x0)), quality);
+            auto ys = scurve(_mm256_sub_ps(y, _mm256_cvtepi32_ps(y0)), quality);
+            auto zs = scurve(_mm256_sub_ps(z, _mm256_cvtepi32_ps(z0)), quality);
+
+            auto ix0 = mix(gradient_noise(x, y, z, x0, y0, z0, seed_term), gradient_noise(x, y, z, x1, y0, z0, seed_term), xs);
+            auto ix1 = mix(gradient_noise(x, y, z, x0, y1, z0, seed_term), gradient_noise(x, y, z, x1, y1, z0, seed_term), xs);
+            auto iy0 = mix(ix0, ix1, ys);
+            ix0 = mix(gradient_noise(x, y, z, x0, y0, z1, seed_term), gradient_noise(x, y, z, x1, y0, z1, seed_term), xs);
+            ix1 = mix(gradient_noise(x, y, z, x0, y1, z1, seed_term), gradient_noise(x, y, z, x1, y1, z1, seed_term), xs);
+            auto iy1 = mix(ix0, ix1, ys);
+
+            _mm256_storeu_ps(values.data() + i, mix(iy0, iy1, zs));
+        }
+
+        return i;
+    }
+}
+
+#endif
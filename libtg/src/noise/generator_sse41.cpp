@@ -0,0 +1,212 @@
+#include "simd.h"
+
+#if TARRAGON_NOISE_X86
+
+#include <smmintrin.h>
+
+#include "tables.h"
+
+namespace tarragon::noise::simd
+{
+    namespace
+    {
+        constexpr size_t DoubleLanes = 2;
+        constexpr size_t FloatLanes = 4;
+
+        // Rounds towards negative infinity like the scalar generator, which
+        // also maps integral values <= 0 to the next lower integer.
+        __m128i floor_pos(__m128d pos)
+        {
+            auto not_positive = _mm_cmpngt_pd(pos, _mm_setzero_pd());
+            auto truncated = _mm_cvttpd_epi32(pos);
+            auto correction = _mm_cvttpd_epi32(_mm_and_pd(not_positive, _mm_set1_pd(1.0)));
+            return _mm_sub_epi32(truncated, correction);
+        }
+
+        __m128d scurve(__m128d a, NoiseQuality quality)
+        {
+            switch (quality)
+            {
+                case NoiseQuality::Fast:
+                    return a;
+                case NoiseQuality::Standard:
+                    return _mm_mul_pd(_mm_mul_pd(a, a), _mm_sub_pd(_mm_set1_pd(3.0), _mm_mul_pd(_mm_set1_pd(2.0), a)));
+                case NoiseQuality::Best:
+                {
+                    auto a3 = _mm_mul_pd(_mm_mul_pd(a, a), a);
+                    auto a4 = _mm_mul_pd(a3, a);
+                    auto a5 = _mm_mul_pd(a4, a);
+                    return _mm_add_pd(
+                        _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(6.0), a5), _mm_mul_pd(_mm_set1_pd(15.0), a4)),
+                        _mm_mul_pd(_mm_set1_pd(10.0), a3));
+                }
+            }
+            return a;
+        }
+
+        // Same operation order as glm::mix
+        __m128d mix(__m128d x, __m128d y, __m128d a)
+        {
+            return _mm_add_pd(_mm_mul_pd(x, _mm_sub_pd(_mm_set1_pd(1.0), a)), _mm_mul_pd(y, a));
+        }
+
+        __m128d gradient_noise(__m128d x, __m128d y, __m128d z, __m128i ix, __m128i iy, __m128i iz, __m128i seed_term)
+        {
+            auto vector_index = _mm_add_epi32(
+                _mm_add_epi32(
+                    _mm_add_epi32(_mm_mullo_epi32(ix, _mm_set1_epi32(NoiseGen.x)), _mm_mullo_epi32(iy, _mm_set1_epi32(NoiseGen.y))),
+                    _mm_mullo_epi32(iz, _mm_set1_epi32(NoiseGen.z))),
+                seed_term);
+            vector_index = _mm_xor_si128(vector_index, _mm_srai_epi32(vector_index, ShiftNoiseGen));
+            vector_index = _mm_and_si128(vector_index, _mm_set1_epi32(0xff));
+            vector_index = _mm_slli_epi32(vector_index, 2);
+
+            auto index0 = static_cast<size_t>(_mm_cvtsi128_si32(vector_index));
+            auto index1 = static_cast<size_t>(_mm_extract_epi32(vector_index, 1));
+            auto xgrad = _mm_setr_pd(VectorTable[index0], VectorTable[index1]);
+            auto ygrad = _mm_setr_pd(VectorTable[index0 + 1], VectorTable[index1 + 1]);
+            auto zgrad = _mm_setr_pd(VectorTable[index0 + 2], VectorTable[index1 + 2]);
+
+            auto xpoint = _mm_sub_pd(x, _mm_cvtepi32_pd(ix));
+            auto ypoint = _mm_sub_pd(y, _mm_cvtepi32_pd(iy));
+            auto zpoint = _mm_sub_pd(z, _mm_cvtepi32_pd(iz));
+
+            auto dot = _mm_add_pd(
+                _mm_add_pd(_mm_mul_pd(xgrad, xpoint), _mm_mul_pd(ygrad, ypoint)),
+                _mm_mul_pd(zgrad, zpoint));
+            return _mm_mul_pd(dot, _mm_set1_pd(2.12));
+        }
+
+        __m128i floor_pos(__m128 pos)
+        {
+            auto not_positive = _mm_cmpngt_ps(pos, _mm_setzero_ps());
+            auto truncated = _mm_cvttps_epi32(pos);
+            auto correction = _mm_cvttps_epi32(_mm_and_ps(not_positive, _mm_set1_ps(1.0f)));
+            return _mm_sub_epi32(truncated, correction);
+        }
+
+        __m128 scurve(__m128 a, NoiseQuality quality)
+        {
+            switch (quality)
+            {
+                case NoiseQuality::Fast:
+                    return a;
+                case NoiseQuality::Standard:
+                    return _mm_mul_ps(_mm_mul_ps(a, a), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), a)));
+                case NoiseQuality::Best:
+                {
+                    auto a3 = _mm_mul_ps(_mm_mul_ps(a, a), a);
+                    auto a4 = _mm_mul_ps(a3, a);
+                    auto a5 = _mm_mul_ps(a4, a);
+                    return _mm_add_ps(
+                        _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(6.0f), a5), _mm_mul_ps(_mm_set1_ps(15.0f), a4)),
+                        _mm_mul_ps(_mm_set1_ps(10.0f), a3));
+                }
+            }
+            return a;
+        }
+
+        __m128 mix(__m128 x, __m128 y, __m128 a)
+        {
+            return _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.0f), a)), _mm_mul_ps(y, a));
+        }
+
+        __m128 gradient_noise(__m128 x, __m128 y, __m128 z, __m128i ix, __m128i iy, __m128i iz, __m128i seed_term)
+        {
+            auto vector_index = _mm_add_epi32(
+                _mm_add_epi32(
+                    _mm_add_epi32(_mm_mullo_epi32(ix, _mm_set1_epi32(NoiseGen.x)), _mm_mullo_epi32(iy, _mm_set1_epi32(NoiseGen.y))),
+                    _mm_mullo_epi32(iz, _mm_set1_epi32(NoiseGen.z))),
+                seed_term);
+            vector_index = _mm_xor_si128(vector_index, _mm_srai_epi32(vector_index, ShiftNoiseGen));
+            vector_index = _mm_and_si128(vector_index, _mm_set1_epi32(0xff));
+            vector_index = _mm_slli_epi32(vector_index, 2);
+
+            auto const& vector_table = VectorTableOf<float>;
+            auto index0 = static_cast<size_t>(_mm_cvtsi128_si32(vector_index));
+            auto index1 = static_cast<size_t>(_mm_extract_epi32(vector_index, 1));
+            auto index2 = static_cast<size_t>(_mm_extract_epi32(vector_index, 2));
+            auto index3 = static_cast<size_t>(_mm_extract_epi32(vector_index, 3));
+            auto xgrad = _mm_setr_ps(vector_table[index0], vector_table[index1], vector_table[index2], vector_table[index3]);
+            auto ygrad = _mm_setr_ps(vector_table[index0 + 1], vector_table[index1 + 1], vector_table[index2 + 1], vector_table[index3 + 1]);
+            auto zgrad = _mm_setr_ps(vector_table[index0 + 2], vector_table[index1 + 2], vector_table[index2 + 2], vector_table[index3 + 2]);
+
+            auto xpoint = _mm_sub_ps(x, _mm_cvtepi32_ps(ix));
+            auto ypoint = _mm_sub_ps(y, _mm_cvtepi32_ps(iy));
+            auto zpoint = _mm_sub_ps(z, _mm_cvtepi32_ps(iz));
+
+            auto dot = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(xgrad, xpoint), _mm_mul_ps(ygrad, ypoint)),
+                _mm_mul_ps(zgrad, zpoint));
+            return _mm_mul_ps(dot, _mm_set1_ps(2.12f));
+        }
+    }
+
+    size_t gradient_coherent_noise_3d_sse41(std::span<glm::dvec3 const> positions, std::span<double> values, int32_t seed, NoiseQuality quality)
+    {
+        auto seed_term = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(SeedNoiseGen) * static_cast<uint32_t>(seed)));
+        auto one = _mm_set1_epi32(1);
+
+        size_t i{};
+        for (; i + DoubleLanes <= positions.size(); i += DoubleLanes)
+        {
+            auto const* p = positions.data() + i;
+            auto x = _mm_setr_pd(p[0].x, p[1].x);
+            auto y = _mm_setr_pd(p[0].y, p[1].y);
+            auto z = _mm_setr_pd(p[0].z, p[1].z);
+
+            auto x0 = floor_pos(x), y0 = floor_pos(y), z0 = floor_pos(z);
+            auto x1 = _mm_add_epi32(x0, one), y1 = _mm_add_epi32(y0, one), z1 = _mm_add_epi32(z0, one);
+
+            auto xs = scurve(_mm_sub_pd(x, _mm_cvtepi32_pd(x0)), quality);
+            auto ys = scurve(_mm_sub_pd(y, _mm_cvtepi32_pd(y0)), quality);
+            auto zs = scurve(_mm_sub_pd(z, _mm_cvtepi32_pd(z0)), quality);
+
+            auto ix0 = mix(gradient_noise(x, y, z, x0, y0, z0, seed_term), gradient_noise(x, y, z, x1, y0, z0, seed_term), xs);
+            auto ix1 = mix(gradient_noise(x, y, z, x0, y1, z0, seed_term), gradient_noise(x, y, z, x1, y1, z0, seed_term), xs);
+            auto iy0 = mix(ix0, ix1, ys);
+            ix0 = mix(gradient_noise(x, y, z, x0, y0, z1, seed_term), gradient_noise(x, y, z, x1, y0, z1, seed_term), xs);
+            ix1 = mix(gradient_noise(x, y, z, x0, y1, z1, seed_term), gradient_noise(x, y, z, x1, y1, z1, seed_term), xs);
+            auto iy1 = mix(ix0, ix1, ys);
+
+            _mm_storeu_pd(values.data() + i, mix(iy0, iy1, zs));
+        }
+
+        return i;
+    }
+
+    size_t gradient_coherent_noise_3d_sse41(std::span<glm::vec3 const> positions, std::span<float> values, int32_t seed, NoiseQuality quality)
+    {
+        auto seed_term = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(SeedNoiseGen) * static_cast<uint32_t>(seed)));
+        auto one = _mm_set1_epi32(1);
+
+        size_t i{};
+        for (; i + FloatLanes <= positions.size(); i += FloatLanes)
+        {
+            auto const* p = positions.data() + i;
+            auto x = _mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x);
+            auto y = _mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y);
+            auto z = _mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z);
+
+            auto x0 = floor_pos(x), y0 = floor_pos(y), z0 = floor_pos(z);
+            auto x1 = _mm_add_epi32(x0, one), y1 = _mm_add_epi32(y0, one), z1 = _mm_add_epi32(z0, one);
+
+            auto xs = scurve(_mm_sub_ps(x, _mm_cvtepi32_ps(x0)), quality);
+            auto ys = scurve(_mm_sub_ps(y, _mm_cvtepi32_ps(y0)), quality);
+            auto zs = scurve(_mm_sub_ps(z, _mm_cvtepi32_ps(z0)), quality);
+
+            auto ix0 = mix(gradient_noise(x, y, z, x0, y0, z0, seed_term), gradient_noise(x, y, z, x1, y0, z0, seed_term), xs);
+            auto ix1 = mix(gradient_noise(x, y, z, x0, y1, z0, seed_term), gradient_noise(x, y, z, x1, y1, z0, seed_term), xs);
+            auto iy0 = mix(ix0, ix1, ys);
+            ix0 = mix(gradient_noise(x, y, z, x0, y0, z1, seed_term), gradient_noise(x, y, z, x1, y0, z1, seed_term), xs);
+            ix1 = mix(gradient_noise(x, y, z, x0, y1, z1, seed_term), gradient_noise(x, y, z, x1, y1, z1, seed_term), xs);
+            auto iy1 = mix(ix0, ix1, ys);
+
+            _mm_storeu_ps(values.data() + i, mix(iy0, iy1, zs));
+        }
+
+        return i;
+    }
+}
+
+#endif
@@ -0,0 +1,916 @@
+#include "noise/graph.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include <glm/glm.hpp>
+#include <glm/ext/quaternion_double.hpp>
+#include <glm/ext/quaternion_float.hpp>
+#include <glm/ext/quaternion_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "noise/generator.h"
+
+namespace tarragon::noise::graph
+{
+    namespace
+    {
+        template <typename T>
+        using Position = typename BasicModule<T>::Position;
+
+        template <typename T>
+        constexpr Interval<T> Unbounded{ -std::numeric_limits<T>::infinity(), std::numeric_limits<T>::infinity() };
+
+        template <typename T>
+        NodePtr<T> make_node(NodeType type, std::vector<double> parameters, std::vector<NodePtr<T>> sources)
+        {
+            return std::make_shared<Node<T> const>(Node<T>{ type, std::move(parameters), std::move(sources), {} });
+        }
+
+        // Rebuilds a graph bottom-up, passing each node to transform after its
+        // sources have been transformed. Nodes shared by several parents are
+        // transformed once.
+        template <typename T, typename F>
+        NodePtr<T> rewrite(NodePtr<T> const& proot, F transform)
+        {
+            std::unordered_map<Node<T> const*, NodePtr<T>> rewritten{};
+
+            auto visit = [&](auto& self, NodePtr<T> const& pnode) -> NodePtr<T>
+            {
+                if (auto it = rewritten.find(pnode.get()); it != std::end(rewritten))
+                    return it->second;
+
+                auto sources = pnode->Sources;
+                bool changed = false;
+                for (auto& psource : sources)
+                {
+                    auto pnew_source = self(self, psource);
+                    changed |= pnew_source != psource;
+                    psource = std::move(pnew_source);
+                }
+
+                auto pcurrent = changed
+                    ? std::make_shared<Node<T> const>(Node<T>{ pnode->Type, pnode->Parameters, std::move(sources), pnode->Module })
+                    : pnode;
+                auto presult = transform(pcurrent);
+                rewritten.emplace(pnode.get(), presult);
+                return presult;
+            };
+
+            return visit(visit, proot);
+        }
+
+        // Scales, then moves the input position before passing it to a source module
+        template <typename T>
+        BasicModule<T> affine_point(BasicModule<T> source, glm::dvec3 const& scale, glm::dvec3 const& translation)
+        {
+            Position<T> tscale{ scale }, ttranslation{ translation };
+
+            auto affine = [=](Position<T> pos)
+            {
+                return source(pos * tscale + ttranslation);
+            };
+
+            auto affine_batch = [=](std::span<Position<T> const> positions, std::span<T> values)
+            {
+                std::vector<Position<T>> mapped_positions(positions.size());
+                for (size_t i = 0; i < positions.size(); i++)
+                    mapped_positions[i] = positions[i] * tscale + ttranslation;
+                source(mapped_positions, values);
+            };
+
+            auto pnode = make_node<T>(NodeType::AffinePoint,
+                { scale.x, scale.y, scale.z, translation.x, translation.y, translation.z }, { from_module(source) });
+            return BasicModule<T>{ affine, affine_batch }.with_node(pnode);
+        }
+
+        // Creates the module for a node from the modules of its sources
+        template <typename T>
+        BasicModule<T> build(Node<T> const& node, std::vector<BasicModule<T>> const& sources)
+        {
+            auto const& p = node.Parameters;
+            auto quality = [](double parameter) { return static_cast<NoiseQuality>(static_cast<int>(parameter)); };
+
+            switch (node.Type)
+            {
+                case NodeType::Opaque:
+                    return node.Module;
+                case NodeType::Abs:
+                    return Abs(sources.at(0));
+                case NodeType::Add:
+                    return Add(sources.at(0), sources.at(1));
+                case NodeType::Billow:
+                    return Billow<T>(p.at(0), p.at(1), static_cast<uint32_t>(p.at(2)), p.at(3), quality(p.at(4)), static_cast<int32_t>(p.at(5)));
+                case NodeType::Blend:
+                    return Blend(sources.at(0), sources.at(1), sources.at(2));
+                case NodeType::Cache:
+                    return Cache(sources.at(0));
+                case NodeType::Cell:
+                    return Cell<T>(static_cast<CellType>(static_cast<int>(p.at(0))), p.at(1), p.at(2), p.at(3) != 0.0, p.at(4), static_cast<int32_t>(p.at(5)));
+                case NodeType::Checkerboard:
+                    return Checkerboard<T>();
+                case NodeType::Clamp:
+                    return Clamp(sources.at(0), p.at(0), p.at(1));
+                case NodeType::Constant:
+                    return Constant<T>(p.at(0));
+                case NodeType::Curve:
+                {
+                    std::vector<ControlPoint> control_points{};
+                    for (size_t i = 0; i + 1 < p.size(); i += 2)
+                        control_points.push_back(ControlPoint{ p.at(i), p.at(i + 1) });
+                    return Curve(sources.at(0), control_points.data(), control_points.size());
+                }
+                case NodeType::Cylinders:
+                    return Cylinders<T>(p.at(0));
+                case NodeType::Displace:
+                    return Displace(sources.at(0), sources.at(1), sources.at(2), sources.at(3));
+                case NodeType::Exponent:
+                    return Exponent(sources.at(0), p.at(0));
+                case NodeType::Invert:
+                    return Invert(sources.at(0));
+                case NodeType::Max:
+                    return Max(sources.at(0), sources.at(1));
+                case NodeType::Min:
+                    return Min(sources.at(0), sources.at(1));
+                case NodeType::Multiply:
+                    return Multiply(sources.at(0), sources.at(1));
+                case NodeType::Perlin:
+                    return Perlin<T>(p.at(0), p.at(1), static_cast<uint32_t>(p.at(2)), p.at(3), quality(p.at(4)), static_cast<int32_t>(p.at(5)));
+                case NodeType::Power:
+                    return Power(sources.at(0), sources.at(1));
+                case NodeType::RidgedMulti:
+                    return RidgedMulti<T>(p.at(0), p.at(1), static_cast<uint32_t>(p.at(2)), quality(p.at(3)), static_cast<int32_t>(p.at(4)));
+                case NodeType::Rotate:
+                    return Rotate(sources.at(0), p.at(0), p.at(1), p.at(2));
+                case NodeType::ScaleBias:
+                    return ScaleBias(sources.at(0), p.at(0), p.at(1));
+                case NodeType::ScalePoint:
+                    return ScalePoint(sources.at(0), glm::dvec3{ p.at(0), p.at(1), p.at(2) });
+                case NodeType::Select:
+                    return Select(sources.at(0), sources.at(1), sources.at(2), p.at(0), p.at(1), p.at(2));
+                case NodeType::Spheres:
+                    return Spheres<T>(p.at(0));
+                case NodeType::Terrace:
+                    return Terrace(sources.at(0), p.data() + 1, p.size() - 1, p.at(0) != 0.0);
+                case NodeType::TranslatePoint:
+                    return TranslatePoint(sources.at(0), glm::dvec3{ p.at(0), p.at(1), p.at(2) });
+                case NodeType::Turbulence:
+                    return Turbulence(sources.at(0), p.at(0), p.at(1), static_cast<uint32_t>(p.at(2)), static_cast<int32_t>(p.at(3)));
+                case NodeType::White:
+                    return White<T>(static_cast<int32_t>(p.at(0)), static_cast<int32_t>(p.at(1)));
+                case NodeType::AffinePoint:
+                    return affine_point(sources.at(0), glm::dvec3{ p.at(0), p.at(1), p.at(2) }, glm::dvec3{ p.at(3), p.at(4), p.at(5) });
+            }
+
+            assert(false);
+            return node.Module;
+        }
+
+        // Builds the modules for a graph. wrap is called with each node and
+        // its module, and returns the module that parents use.
+        template <typename T, typename F>
+        BasicModule<T> build_graph(NodePtr<T> const& proot, F wrap)
+        {
+            std::unordered_map<Node<T> const*, BasicModule<T>> built{};
+
+            auto visit = [&](auto& self, NodePtr<T> const& pnode) -> BasicModule<T>
+            {
+                if (auto it = built.find(pnode.get()); it != std::end(built))
+                    return it->second;
+
+                std::vector<BasicModule<T>> sources{};
+                for (auto const& psource : pnode->Sources)
+                    sources.push_back(self(self, psource));
+
+                auto module = wrap(pnode, build(*pnode, sources));
+                built.emplace(pnode.get(), module);
+                return module;
+            };
+
+            return visit(visit, proot);
+        }
+
+        // Whether the output value of a node type only depends on the output value of its sources
+        bool is_value_operation(NodeType type)
+        {
+            switch (type)
+            {
+                case NodeType::Abs:
+                case NodeType::Add:
+                case NodeType::Blend:
+                case NodeType::Clamp:
+                case NodeType::Curve:
+                case NodeType::Exponent:
+                case NodeType::Invert:
+                case NodeType::Max:
+                case NodeType::Min:
+                case NodeType::Multiply:
+                case NodeType::Power:
+                case NodeType::ScaleBias:
+                case NodeType::Select:
+                case NodeType::Terrace:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // Whether a node type outputs the value of its first source at a transformed position
+        bool is_position_operation(NodeType type)
+        {
+            switch (type)
+            {
+                case NodeType::Cache:
+                case NodeType::Displace:
+                case NodeType::Rotate:
+                case NodeType::ScalePoint:
+                case NodeType::TranslatePoint:
+                case NodeType::Turbulence:
+                case NodeType::AffinePoint:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // A position transform pos * Scale + Translation
+        struct Affine
+        {
+            glm::dvec3 Scale;
+            glm::dvec3 Translation;
+        };
+
+        template <typename T>
+        bool to_affine(Node<T> const& node, Affine& affine)
+        {
+            auto const& p = node.Parameters;
+            switch (node.Type)
+            {
+                case NodeType::ScalePoint:
+                    affine = { { p.at(0), p.at(1), p.at(2) }, glm::dvec3{ 0.0 } };
+                    return true;
+                case NodeType::TranslatePoint:
+                    affine = { glm::dvec3{ 1.0 }, { p.at(0), p.at(1), p.at(2) } };
+                    return true;
+                case NodeType::AffinePoint:
+                    affine = { { p.at(0), p.at(1), p.at(2) }, { p.at(3), p.at(4), p.at(5) } };
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        template <typename T>
+        Interval<T> make_interval(T a, T b)
+        {
+            // NaN bounds come from multiplying zero and infinity; nothing is known then.
+            if (a != a || b != b)
+                return Unbounded<T>;
+            return { glm::min(a, b), glm::max(a, b) };
+        }
+
+        template <typename T>
+        Interval<T> add_intervals(Interval<T> const& a, Interval<T> const& b)
+        {
+            return make_interval(a.Lower + b.Lower, a.Upper + b.Upper);
+        }
+
+        template <typename T>
+        Interval<T> multiply_intervals(Interval<T> const& a, Interval<T> const& b)
+        {
+            std::array<T, 4> products
+            {
+                a.Lower * b.Lower, a.Lower * b.Upper,
+                a.Upper * b.Lower, a.Upper * b.Upper
+            };
+            if (std::ranges::any_of(products, [](T product) { return product != product; }))
+                return Unbounded<T>;
+            return { std::ranges::min(products), std::ranges::max(products) };
+        }
+
+        template <typename T>
+        Interval<T> scale_bias_interval(Interval<T> const& a, T scale, T bias)
+        {
+            return make_interval(a.Lower * scale + bias, a.Upper * scale + bias);
+        }
+
+        template <typename T>
+        Interval<T> abs_interval(Interval<T> const& a)
+        {
+            if (a.Lower >= T{ 0 })
+                return a;
+            if (a.Upper <= T{ 0 })
+                return { -a.Upper, -a.Lower };
+            return { T{ 0 }, glm::max(-a.Lower, a.Upper) };
+        }
+
+        template <typename T>
+        Interval<T> square_interval(Interval<T> const& a)
+        {
+            auto [lower, upper] = abs_interval(a);
+            return { lower * lower, upper * upper };
+        }
+
+        template <typename T>
+        Interval<T> clamp_interval(Interval<T> const& a, T lower_bound, T upper_bound)
+        {
+            return { glm::clamp(a.Lower, lower_bound, upper_bound), glm::clamp(a.Upper, lower_bound, upper_bound) };
+        }
+
+        template <typename T>
+        Interval<T> hull(Interval<T> const& a, Interval<T> const& b)
+        {
+            return { glm::min(a.Lower, b.Lower), glm::max(a.Upper, b.Upper) };
+        }
+
+        template <typename T>
+        constexpr Box<T> Everywhere{ glm::vec<3, T>{ -std::numeric_limits<T>::infinity() }, glm::vec<3, T>{ std::numeric_limits<T>::infinity() } };
+
+        // The box of the positions of a box multiplied by factor
+        template <typename T>
+        Box<T> scale_box(Box<T> const& box, glm::vec<3, T> const& factor)
+        {
+            Box<T> scaled{};
+            for (int axis = 0; axis < 3; axis++)
+            {
+                // Infinite bounds scaled by zero are zero, not NaN
+                if (factor[axis] == T{ 0 })
+                    continue;
+
+                auto lower = box.Lower[axis] * factor[axis], upper = box.Upper[axis] * factor[axis];
+                scaled.Lower[axis] = glm::min(lower, upper);
+                scaled.Upper[axis] = glm::max(lower, upper);
+            }
+            return scaled;
+        }
+
+        // The box of the positions of a box moved by offsets in the given ranges
+        template <typename T>
+        Box<T> displace_box(Box<T> const& box, Interval<T> const& x, Interval<T> const& y, Interval<T> const& z)
+        {
+            return
+            {
+                box.Lower + glm::vec<3, T>{ x.Lower, y.Lower, z.Lower },
+                box.Upper + glm::vec<3, T>{ x.Upper, y.Upper, z.Upper },
+            };
+        }
+
+        // The box around the positions of a box rotated by a quaternion
+        template <typename T>
+        Box<T> rotate_box(Box<T> const& box, glm::qua<T> const& rotation)
+        {
+            if (!glm::all(glm::isfinite(box.Lower)) || !glm::all(glm::isfinite(box.Upper)))
+                return Everywhere<T>;
+
+            Box<T> rotated{ glm::vec<3, T>{ std::numeric_limits<T>::infinity() }, glm::vec<3, T>{ -std::numeric_limits<T>::infinity() } };
+            for (int corner = 0; corner < 8; corner++)
+            {
+                glm::vec<3, T> position
+                {
+                    (corner & 1) != 0 ? box.Upper.x : box.Lower.x,
+                    (corner & 2) != 0 ? box.Upper.y : box.Lower.y,
+                    (corner & 4) != 0 ? box.Upper.z : box.Lower.z,
+                };
+                position = rotation * position;
+                rotated.Lower = glm::min(rotated.Lower, position);
+                rotated.Upper = glm::max(rotated.Upper, position);
+            }
+            return rotated;
+        }
+
+        // Calls f(range, octave) with the range of the gradient coherent
+        // noise of each octave of a fractal generator, for the positions
+        // scaled the same way the generator scales them
+        template <typename T, typename F>
+        void for_each_octave_range(Box<T> box, double frequency, double lacunarity, uint32_t octave_count, NoiseQuality quality, int32_t seed, F f)
+        {
+            box = scale_box(box, glm::vec<3, T>{ static_cast<T>(frequency) });
+            for (uint32_t octave = 0; octave < octave_count; octave++)
+            {
+                int32_t octave_seed = (seed + static_cast<int32_t>(octave)) & INT32_MAX;
+                f(gradient_coherent_noise_3d_range(box, octave_seed, quality), octave);
+                box = scale_box(box, glm::vec<3, T>{ static_cast<T>(lacunarity) });
+            }
+        }
+
+        // Mirrors the octave sums of expr::Perlin, expr::Billow and
+        // expr::RidgedMulti in interval arithmetic
+        template <typename T>
+        Interval<T> perlin_range(Box<T> const& box, double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
+        {
+            Interval<T> value{};
+            T current_persistence{ 1 };
+            for_each_octave_range(box, frequency, lacunarity, octave_count, quality, seed, [&](Interval<T> const& signal, uint32_t)
+            {
+                value = add_intervals(value, scale_bias_interval(signal, current_persistence, T{ 0 }));
+                current_persistence *= static_cast<T>(persistence);
+            });
+            return value;
+        }
+
+        template <typename T>
+        Interval<T> billow_range(Box<T> const& box, double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
+        {
+            Interval<T> value{};
+            T current_persistence{ 1 };
+            for_each_octave_range(box, frequency, lacunarity, octave_count, quality, seed, [&](Interval<T> const& noise, uint32_t)
+            {
+                auto signal = scale_bias_interval(abs_interval(noise), T{ 2 }, T{ -1 });
+                value = add_intervals(value, scale_bias_interval(signal, current_persistence, T{ 0 }));
+                current_persistence *= static_cast<T>(persistence);
+            });
+            return scale_bias_interval(value, T{ 1 }, T{ 0.5 });
+        }
+
+        template <typename T>
+        Interval<T> ridged_multi_range(Box<T> const& box, double frequency, double lacunarity, uint32_t octave_count, NoiseQuality quality, int32_t seed)
+        {
+            Interval<T> value{};
+            Interval<T> weight{ T{ 1 }, T{ 1 } };
+            double weight_frequency = 1.0;
+            for_each_octave_range(box, frequency, lacunarity, octave_count, quality, seed, [&](Interval<T> const& noise, uint32_t)
+            {
+                auto spectral_weight = static_cast<T>(glm::pow(weight_frequency, -1.0));
+                weight_frequency *= lacunarity;
+
+                auto signal = square_interval(scale_bias_interval(abs_interval(noise), T{ -1 }, T{ 1 }));
+                signal = multiply_intervals(signal, weight);
+                weight = clamp_interval(scale_bias_interval(signal, T{ 2 }, T{ 0 }), T{ 0 }, T{ 1 });
+                value = add_intervals(value, scale_bias_interval(signal, spectral_weight, T{ 0 }));
+            });
+            return scale_bias_interval(value, T{ 1.25 }, T{ -1 });
+        }
+
+        // Decides which source a Select node always outputs, given the
+        // range of its control values
+        enum class SelectOutcome
+        {
+            Either,
+            Source0,
+            Source1,
+        };
+
+        // Mirrors the comparisons that Select makes for each control value
+        template <typename T>
+        SelectOutcome select_outcome(Interval<T> control_range, T lower_bound, T upper_bound, T edge_falloff)
+        {
+            if (edge_falloff > T{ 0 })
+            {
+                if (control_range.Upper < (lower_bound - edge_falloff) || control_range.Lower >= (upper_bound + edge_falloff))
+                    return SelectOutcome::Source0;
+                if (control_range.Lower >= (lower_bound + edge_falloff) && control_range.Upper < (upper_bound - edge_falloff))
+                    return SelectOutcome::Source1;
+            }
+            else
+            {
+                if (control_range.Upper < lower_bound || control_range.Lower > upper_bound)
+                    return SelectOutcome::Source0;
+                if (control_range.Lower >= lower_bound && control_range.Upper <= upper_bound)
+                    return SelectOutcome::Source1;
+            }
+            return SelectOutcome::Either;
+        }
+
+        // The ranges of the nodes already visited, with the box they were
+        // visited for. Nodes shared by parents that transform the position
+        // differently are visited again for each box.
+        template <typename T>
+        using RangeCache = std::unordered_map<Node<T> const*, std::pair<Box<T>, Interval<T>>>;
+
+        template <typename T>
+        Interval<T> value_range(NodePtr<T> const& pnode, Box<T> const& box, RangeCache<T>& ranges)
+        {
+            if (auto it = ranges.find(pnode.get()); it != std::end(ranges) && it->second.first == box)
+                return it->second.second;
+
+            auto const& p = pnode->Parameters;
+            auto quality = [](double parameter) { return static_cast<NoiseQuality>(static_cast<int>(parameter)); };
+            auto source_range = [&](size_t index, Box<T> const& source_box) { return value_range(pnode->Sources.at(index), source_box, ranges); };
+
+            Interval<T> range = Unbounded<T>;
+            switch (pnode->Type)
+            {
+                case NodeType::Constant:
+                {
+                    auto value = static_cast<T>(p.at(0));
+                    range = { value, value };
+                    break;
+                }
+                case NodeType::Checkerboard:
+                case NodeType::Cylinders:
+                case NodeType::Spheres:
+                case NodeType::White:
+                    range = { T{ -1 }, T{ 1 } };
+                    break;
+                case NodeType::Cell:
+                {
+                    // The distance to the nearest seed point isn't bounded here
+                    if (p.at(3) == 0.0)
+                    {
+                        auto displacement = glm::abs(static_cast<T>(p.at(1)));
+                        range = { -displacement, displacement };
+                    }
+                    break;
+                }
+                case NodeType::Perlin:
+                    range = perlin_range(box, p.at(0), p.at(1), static_cast<uint32_t>(p.at(2)), p.at(3), quality(p.at(4)), static_cast<int32_t>(p.at(5)));
+                    break;
+                case NodeType::Billow:
+                    range = billow_range(box, p.at(0), p.at(1), static_cast<uint32_t>(p.at(2)), p.at(3), quality(p.at(4)), static_cast<int32_t>(p.at(5)));
+                    break;
+                case NodeType::RidgedMulti:
+                    range = ridged_multi_range(box, p.at(0), p.at(1), static_cast<uint32_t>(p.at(2)), quality(p.at(3)), static_cast<int32_t>(p.at(4)));
+                    break;
+                case NodeType::Abs:
+                    range = abs_interval(source_range(0, box));
+                    break;
+                case NodeType::Invert:
+                {
+                    auto [lower, upper] = source_range(0, box);
+                    range = { -upper, -lower };
+                    break;
+                }
+                case NodeType::Clamp:
+                    range = clamp_interval(source_range(0, box), static_cast<T>(p.at(0)), static_cast<T>(p.at(1)));
+                    break;
+                case NodeType::ScaleBias:
+                    range = scale_bias_interval(source_range(0, box), static_cast<T>(p.at(0)), static_cast<T>(p.at(1)));
+                    break;
+                case NodeType::Exponent:
+                {
+                    // Increasing in the absolute value of the source for
+                    // exponents of 0 and more
+                    auto exponent = static_cast<T>(p.at(0));
+                    if (exponent >= T{ 0 })
+                    {
+                        auto [lower, upper] = abs_interval(scale_bias_interval(source_range(0, box), T{ 0.5 }, T{ 0.5 }));
+                        range = scale_bias_interval(Interval<T>{ glm::pow(lower, exponent), glm::pow(upper, exponent) }, T{ 2 }, T{ -1 });
+                    }
+                    break;
+                }
+                case NodeType::Terrace:
+                {
+                    // Outputs are interpolated between the control points
+                    auto [lower, upper] = std::minmax_element(std::begin(p) + 1, std::end(p));
+                    range = { static_cast<T>(*lower), static_cast<T>(*upper) };
+                    break;
+                }
+                case NodeType::Add:
+                    range = add_intervals(source_range(0, box), source_range(1, box));
+                    break;
+                case NodeType::Multiply:
+                    range = multiply_intervals(source_range(0, box), source_range(1, box));
+                    break;
+                case NodeType::Max:
+                {
+                    auto range0 = source_range(0, box), range1 = source_range(1, box);
+                    range = { glm::max(range0.Lower, range1.Lower), glm::max(range0.Upper, range1.Upper) };
+                    break;
+                }
+                case NodeType::Min:
+                {
+                    auto range0 = source_range(0, box), range1 = source_range(1, box);
+                    range = { glm::min(range0.Lower, range1.Lower), glm::min(range0.Upper, range1.Upper) };
+                    break;
+                }
+                case NodeType::Blend:
+                {
+                    // source0 + control * (source1 - source0)
+                    auto range0 = source_range(0, box), range1 = source_range(1, box);
+                    auto difference = add_intervals(range1, Interval<T>{ -range0.Upper, -range0.Lower });
+                    range = add_intervals(range0, multiply_intervals(source_range(2, box), difference));
+                    break;
+                }
+                case NodeType::Select:
+                {
+                    auto lower_bound = static_cast<T>(p.at(0)), upper_bound = static_cast<T>(p.at(1)), edge_falloff = static_cast<T>(p.at(2));
+                    switch (select_outcome(source_range(2, box), lower_bound, upper_bound, edge_falloff))
+                    {
+                        case SelectOutcome::Source0:
+                            range = source_range(0, box);
+                            break;
+                        case SelectOutcome::Source1:
+                            range = source_range(1, box);
+                            break;
+                        case SelectOutcome::Either:
+                            // With an edge falloff, the blended values aren't bounded by the sources.
+                            if (edge_falloff <= T{ 0 })
+                                range = hull(source_range(0, box), source_range(1, box));
+                            break;
+                    }
+                    break;
+                }
+                case NodeType::Cache:
+                    range = source_range(0, box);
+                    break;
+                case NodeType::Displace:
+                    range = source_range(0, displace_box(box, source_range(1, box), source_range(2, box), source_range(3, box)));
+                    break;
+                case NodeType::Turbulence:
+                {
+                    // The distortion is bounded by the range of its Perlin
+                    // noise everywhere, which doesn't depend on its offsets
+                    auto distortion = perlin_range(Everywhere<T>, p.at(0), PerlinDefaultLacunarity, static_cast<uint32_t>(p.at(2)), PerlinDefaultPersistence, DefaultQuality, static_cast<int32_t>(p.at(3)));
+                    distortion = scale_bias_interval(distortion, static_cast<T>(p.at(1)), T{ 0 });
+                    range = source_range(0, displace_box(box, distortion, distortion, distortion));
+                    break;
+                }
+                case NodeType::Rotate:
+                {
+                    // Same rotation as Rotate
+                    constexpr glm::dquat quat_id = glm::identity<glm::quat>();
+                    auto qx = glm::rotate(quat_id, glm::radians(p.at(0)), glm::dvec3{ 1.0, 0.0, 0.0 });
+                    auto qy = glm::rotate(quat_id, glm::radians(p.at(1)), glm::dvec3{ 0.0, 1.0, 0.0 });
+                    auto qz = glm::rotate(quat_id, glm::radians(p.at(2)), glm::dvec3{ 0.0, 0.0, 1.0 });
+                    range = source_range(0, rotate_box(box, glm::qua<T>{ qx * qy * qz }));
+                    break;
+                }
+                case NodeType::ScalePoint:
+                case NodeType::TranslatePoint:
+                case NodeType::AffinePoint:
+                {
+                    Affine affine{};
+                    to_affine(*pnode, affine);
+                    auto scaled = scale_box(box, glm::vec<3, T>{ affine.Scale });
+                    auto translation = glm::vec<3, T>{ affine.Translation };
+                    range = source_range(0, Box<T>{ scaled.Lower + translation, scaled.Upper + translation });
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            ranges.insert_or_assign(pnode.get(), std::pair{ box, range });
+            return range;
+        }
+
+        template <typename T>
+        size_t node_hash(Node<T> const& node)
+        {
+            auto combine = [](size_t seed, size_t value) { return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)); };
+
+            size_t hash = std::hash<int>{}(static_cast<int>(node.Type));
+            for (auto parameter : node.Parameters)
+                hash = combine(hash, std::hash<uint64_t>{}(std::bit_cast<uint64_t>(parameter)));
+            for (auto const& psource : node.Sources)
+                hash = combine(hash, std::hash<Node<T> const*>{}(psource.get()));
+            return hash;
+        }
+
+        // Whether two nodes compute the same values, given that their
+        // sources have already been deduplicated
+        template <typename T>
+        bool node_equal(Node<T> const& a, Node<T> const& b)
+        {
+            auto same_bits = [](double x, double y) { return std::bit_cast<uint64_t>(x) == std::bit_cast<uint64_t>(y); };
+
+            return a.Type == b.Type
+                && std::ranges::equal(a.Parameters, b.Parameters, same_bits)
+                && a.Sources == b.Sources
+                && a.Module == b.Module;
+        }
+
+        template <typename T>
+        struct MemoEntry
+        {
+            std::vector<Position<T>> Positions;
+            std::vector<T> Values;
+        };
+
+        // Memoized values of the shared nodes of the compiled graph that is
+        // currently being evaluated on this thread
+        template <typename T>
+        thread_local std::vector<MemoEntry<T>>* t_pmemo = nullptr;
+
+        // Outputs the values of a source module, evaluating it only once
+        // for consecutive batches of the same positions
+        template <typename T>
+        BasicModule<T> memoize(BasicModule<T> source, size_t index)
+        {
+            auto memoized_batch = [source, index](std::span<Position<T> const> positions, std::span<T> values)
+            {
+                assert(t_pmemo<T> != nullptr);
+
+                auto& entry = t_pmemo<T>->at(index);
+                if (std::ranges::equal(positions, entry.Positions))
+                {
+                    std::ranges::copy(entry.Values, std::begin(values));
+                    return;
+                }
+
+                source(positions, values);
+                entry.Positions.assign(std::begin(positions), std::end(positions));
+                entry.Values.assign(std::begin(values), std::begin(values) + positions.size());
+            };
+
+            return BasicModule<T>{ [source](Position<T> pos) { return source(pos); }, memoized_batch };
+        }
+    }
+
+    template <typename T>
+    NodePtr<T> from_module(BasicModule<T> const& module)
+    {
+        if (module.node())
+            return module.node();
+
+        return std::make_shared<Node<T> const>(Node<T>{ NodeType::Opaque, {}, {}, module });
+    }
+
+    template <typename T>
+    Interval<T> value_range(NodePtr<T> const& pnode)
+    {
+        return value_range(pnode, Everywhere<T>);
+    }
+
+    template <typename T>
+    Interval<T> value_range(NodePtr<T> const& pnode, Box<T> const& box)
+    {
+        RangeCache<T> ranges{};
+        return value_range(pnode, box, ranges);
+    }
+
+    template <typename T>
+    NodePtr<T> fold_constants(NodePtr<T> const& pnode)
+    {
+        auto is_constant = [](NodePtr<T> const& psource) { return psource->Type == NodeType::Constant; };
+
+        return rewrite(pnode, [&](NodePtr<T> const& pcurrent) -> NodePtr<T>
+        {
+            // Transforming the position of a constant doesn't change it.
+            if (is_position_operation(pcurrent->Type) && is_constant(pcurrent->Sources.at(0)))
+                return pcurrent->Sources.at(0);
+
+            if (is_value_operation(pcurrent->Type) && std::ranges::all_of(pcurrent->Sources, is_constant))
+            {
+                std::vector<BasicModule<T>> sources{};
+                for (auto const& psource : pcurrent->Sources)
+                    sources.push_back(build(*psource, {}));
+
+                auto value = build(*pcurrent, sources)(Position<T>{});
+                return make_node<T>(NodeType::Constant, { static_cast<double>(value) }, {});
+            }
+
+            return pcurrent;
+        });
+    }
+
+    template <typename T>
+    NodePtr<T> merge_affine(NodePtr<T> const& pnode)
+    {
+        return rewrite(pnode, [](NodePtr<T> const& pcurrent) -> NodePtr<T>
+        {
+            auto const& psource = pcurrent->Sources.empty() ? nullptr : pcurrent->Sources.front();
+
+            if (pcurrent->Type == NodeType::ScaleBias)
+            {
+                double scale = pcurrent->Parameters.at(0);
+                double bias = pcurrent->Parameters.at(1);
+                if (psource->Type == NodeType::ScaleBias)
+                {
+                    // (value * inner_scale + inner_bias) * scale + bias
+                    double inner_scale = psource->Parameters.at(0);
+                    double inner_bias = psource->Parameters.at(1);
+                    return make_node<T>(NodeType::ScaleBias, { inner_scale * scale, inner_bias * scale + bias }, { psource->Sources.at(0) });
+                }
+                if (scale == 1.0 && bias == 0.0)
+                    return psource;
+                return pcurrent;
+            }
+
+            Affine outer{}, inner{};
+            if (!to_affine(*pcurrent, outer))
+                return pcurrent;
+
+            auto ptarget = psource;
+            Affine merged = outer;
+            if (to_affine(*psource, inner))
+            {
+                // The outer transform is applied to the position first.
+                merged = { outer.Scale * inner.Scale, outer.Translation * inner.Scale + inner.Translation };
+                ptarget = psource->Sources.at(0);
+            }
+
+            if (merged.Scale == glm::dvec3{ 1.0 } && merged.Translation == glm::dvec3{ 0.0 })
+                return ptarget;
+            if (ptarget == psource)
+                return pcurrent;
+
+            return make_node<T>(NodeType::AffinePoint,
+                { merged.Scale.x, merged.Scale.y, merged.Scale.z, merged.Translation.x, merged.Translation.y, merged.Translation.z },
+                { ptarget });
+        });
+    }
+
+    template <typename T>
+    NodePtr<T> eliminate_dead_branches(NodePtr<T> const& pnode)
+    {
+        RangeCache<T> ranges{};
+
+        return rewrite(pnode, [&](NodePtr<T> const& pcurrent) -> NodePtr<T>
+        {
+            if (pcurrent->Type != NodeType::Select)
+                return pcurrent;
+
+            auto const& p = pcurrent->Parameters;
+            auto control_range = value_range(pcurrent->Sources.at(2), Everywhere<T>, ranges);
+            switch (select_outcome(control_range, static_cast<T>(p.at(0)), static_cast<T>(p.at(1)), static_cast<T>(p.at(2))))
+            {
+                case SelectOutcome::Source0:
+                    return pcurrent->Sources.at(0);
+                case SelectOutcome::Source1:
+                    return pcurrent->Sources.at(1);
+                default:
+                    return pcurrent;
+            }
+        });
+    }
+
+    template <typename T>
+    NodePtr<T> eliminate_common_subgraphs(NodePtr<T> const& pnode)
+    {
+        std::unordered_map<size_t, std::vector<NodePtr<T>>> unique_nodes{};
+
+        // Sources are deduplicated before their parents, so comparing
+        // source pointers is enough to compare whole subgraphs.
+        return rewrite(pnode, [&](NodePtr<T> const& pcurrent) -> NodePtr<T>
+        {
+            auto& bucket = unique_nodes[node_hash(*pcurrent)];
+            for (auto const& punique : bucket)
+            {
+                if (node_equal(*punique, *pcurrent))
+                    return punique;
+            }
+
+            bucket.push_back(pcurrent);
+            return pcurrent;
+        });
+    }
+
+    template <typename T>
+    NodePtr<T> optimize(NodePtr<T> const& pnode)
+    {
+        auto poptimized = fold_constants(pnode);
+        poptimized = merge_affine(poptimized);
+        poptimized = eliminate_dead_branches(poptimized);
+        poptimized = fold_constants(poptimized);
+        return eliminate_common_subgraphs(poptimized);
+    }
+
+    template <typename T>
+    BasicModule<T> compile(NodePtr<T> const& pnode)
+    {
+        // Count the parents of each node to find the shared ones.
+        std::unordered_map<Node<T> const*, size_t> parent_counts{};
+        auto count_parents = [&](auto& self, NodePtr<T> const& pcurrent) -> void
+        {
+            for (auto const& psource : pcurrent->Sources)
+            {
+                if (parent_counts[psource.get()]++ == 0)
+                    self(self, psource);
+            }
+        };
+        count_parents(count_parents, pnode);
+
+        auto scalar_root = build_graph(pnode, [](NodePtr<T> const&, BasicModule<T> module) { return module; });
+
+        size_t shared_count{};
+        auto batch_root = build_graph(pnode, [&](NodePtr<T> const& pcurrent, BasicModule<T> module)
+        {
+            return parent_counts[pcurrent.get()] > 1 ? memoize(module, shared_count++) : module;
+        });
+
+        if (shared_count == 0)
+            return scalar_root.with_node(pnode);
+
+        auto batch = [batch_root, shared_count](std::span<Position<T> const> positions, std::span<T> values)
+        {
+            std::vector<MemoEntry<T>> memo(shared_count);
+            auto pprevious_memo = std::exchange(t_pmemo<T>, &memo);
+            batch_root(positions, values);
+            t_pmemo<T> = pprevious_memo;
+        };
+
+        return BasicModule<T>{ [scalar_root](Position<T> pos) { return scalar_root(pos); }, batch }.with_node(pnode);
+    }
+
+#define TARRAGON_NOISE_INSTANTIATE_GRAPH(T) \
+    template NodePtr<T> from_module(BasicModule<T> const&); \
+    template Interval<T> value_range(NodePtr<T> const&); \
+    template Interval<T> value_range(NodePtr<T> const&, Box<T> const&); \
+    template NodePtr<T> fold_constants(NodePtr<T> const&); \
+    template NodePtr<T> merge_affine(NodePtr<T> const&); \
+    template NodePtr<T> eliminate_dead_branches(NodePtr<T> const&); \
+    template NodePtr<T> eliminate_common_subgraphs(NodePtr<T> const&); \
+    template NodePtr<T> optimize(NodePtr<T> const&); \
+    template BasicModule<T> compile(NodePtr<T> const&);
+
+    TARRAGON_NOISE_INSTANTIATE_GRAPH(float)
+    TARRAGON_NOISE_INSTANTIATE_GRAPH(double)
+
+#undef TARRAGON_NOISE_INSTANTIATE_GRAPH
+}
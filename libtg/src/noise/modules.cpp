@@ -1,9 +1,12 @@
 #include "noise/modules.h"
 
+#include <cassert>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <algorithm>
-#include <array>
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -16,106 +19,313 @@
 #include <glm/gtx/spline.hpp>
 
 #include "common.h"
+#include "noise/expressions.h"
 #include "noise/generator.h"
+#include "noise/graph.h"
 
-namespace
+namespace tarragon::noise
 {
-    struct CacheEntry
+    namespace
     {
-        glm::dvec3 pos;
-        double val;
-    };
+        template <typename T>
+        using Position = typename BasicModule<T>::Position;
 
-    constexpr std::array<double, tarragon::noise::RidgedMultiMaxOctaveCount> calc_ridgedmulti_spectral_weights(double lacunarity)
-    {
-        const double h = 1.0;
-        std::array<double, tarragon::noise::RidgedMultiMaxOctaveCount> weights{};
+        // The values last evaluated by one Cache module on one thread
+        template <typename T>
+        struct CacheEntry
+        {
+            std::weak_ptr<uint64_t const> Owner;
+
+            bool HasValue{};
+            Position<T> Pos{};
+            T Value{};
 
-        double frequency = 1.0;
-        for (size_t i = 0; i < weights.size(); i++)
+            std::vector<Position<T>> Positions;
+            std::vector<T> Values;
+        };
+
+        // Gets the entry of a Cache module, identified by its unique id, for the
+        // calling thread. Entries of destroyed modules are dropped when new ones
+        // are added.
+        template <typename T>
+        CacheEntry<T>& cache_entry(std::shared_ptr<uint64_t const> const& pid)
         {
-            weights.at(i) = glm::pow(frequency, -h);
-            frequency *= lacunarity;
+            thread_local std::unordered_map<uint64_t, CacheEntry<T>> entries{};
+
+            if (auto it = entries.find(*pid); it != std::end(entries))
+                return it->second;
+
+            std::erase_if(entries, [](auto const& item) { return item.second.Owner.expired(); });
+            auto& entry = entries[*pid];
+            entry.Owner = pid;
+            return entry;
         }
 
-        return weights;
-    }
-}
+        template <typename T, typename TOp>
+        BasicModule<T> map_values(BasicModule<T> source, TOp op)
+        {
+            return BasicModule<T>
+            {
+                [source, op](Position<T> pos)
+                {
+                    return op(source(pos));
+                },
+                [source, op](std::span<Position<T> const> positions, std::span<T> values)
+                {
+                    source(positions, values);
+                    for (size_t i = 0; i < positions.size(); i++)
+                        values[i] = op(values[i]);
+                }
+            };
+        }
 
-namespace tarragon::noise
-{
-    Module Abs(Module source)
-    {
-        return [=](glm::dvec3 pos)
+        // Creates a module that combines the output values of two source modules
+        template <typename T, typename TOp>
+        BasicModule<T> combine_values(BasicModule<T> source0, BasicModule<T> source1, TOp op)
+        {
+            return BasicModule<T>
+            {
+                [source0, source1, op](Position<T> pos)
+                {
+                    return op(source0(pos), source1(pos));
+                },
+                [source0, source1, op](std::span<Position<T> const> positions, std::span<T> values)
+                {
+                    std::vector<T> values1(positions.size());
+                    source0(positions, values);
+                    source1(positions, values1);
+                    for (size_t i = 0; i < positions.size(); i++)
+                        values[i] = op(values[i], values1[i]);
+                }
+            };
+        }
+
+        // Creates a module that transforms each input position before
+        // passing it to a source module
+        template <typename T, typename TOp>
+        BasicModule<T> map_positions(BasicModule<T> source, TOp op)
+        {
+            return BasicModule<T>
+            {
+                [source, op](Position<T> pos)
+                {
+                    return source(op(pos));
+                },
+                [source, op](std::span<Position<T> const> positions, std::span<T> values)
+                {
+                    std::vector<Position<T>> mapped_positions(positions.size());
+                    for (size_t i = 0; i < positions.size(); i++)
+                        mapped_positions[i] = op(positions[i]);
+                    source(mapped_positions, values);
+                }
+            };
+        }
+
+        // Converts factory arguments to graph node parameters
+        template <typename... TArgs>
+        std::vector<double> parameters(TArgs... args)
         {
-            return glm::abs(source(pos));
+            return { static_cast<double>(args)... };
+        }
+
+        // Creates the graph node describing a module
+        template <typename T, typename... TSources>
+        graph::NodePtr<T> make_node(graph::NodeType type, std::vector<double> parameters, TSources const&... sources)
+        {
+            return std::make_shared<graph::Node<T> const>(graph::Node<T>{ type, std::move(parameters), { graph::from_module(sources)... }, {} });
+        }
+
+        enum class Selection
+        {
+            Source0,
+            Source1,
+            LowerEdge,
+            UpperEdge,
         };
-    }
 
-    Module Add(Module source0, Module source1)
-    {
-        return [=](glm::dvec3 pos)
+        template <typename T>
+        struct SelectResult
         {
-            return source0(pos) + source1(pos);
+            Selection Selected;
+            T Alpha;
         };
+
+        // Decides which source values Select outputs for a control value
+        template <typename T>
+        SelectResult<T> select_sources(T control_value, T lower_bound, T upper_bound, T edge_falloff)
+        {
+            if (edge_falloff > T{ 0 })
+            {
+                if (control_value < (lower_bound - edge_falloff))
+                {
+                    // The output value from the control module is below the selector
+                    // threshold; return the output value from the first source module.
+                    return { Selection::Source0, T{ 0 } };
+                }
+                else if (control_value < (lower_bound + edge_falloff))
+                {
+                    // The output value from the control module is near the lower end of the
+                    // selector threshold and within the smooth curve. Interpolate between
+                    // the output values from the first and second source modules.
+                    auto lower_curve = lower_bound - edge_falloff;
+                    auto upper_curve = lower_bound + edge_falloff;
+                    auto alpha = scurve3((control_value - lower_curve) / (upper_curve / lower_curve));
+                    return { Selection::LowerEdge, alpha };
+                }
+                else if (control_value < (upper_bound - edge_falloff))
+                {
+                    // The output value from the control module is within the selector
+                    // threshold; return the output value from the second source module.
+                    return { Selection::Source1, T{ 0 } };
+                }
+                else if (control_value < (upper_bound + edge_falloff))
+                {
+                    // The output value from the control module is near the upper end of the
+                    // selector threshold and within the smooth curve. Interpolate between
+                    // the output values from the first and second source modules.
+                    auto lower_curve = upper_bound - edge_falloff;
+                    auto upper_curve = upper_bound + edge_falloff;
+                    auto alpha = scurve3((control_value - lower_curve) / (upper_curve / lower_curve));
+                    return { Selection::UpperEdge, alpha };
+                }
+                else
+                {
+                    // Output value from the control module is above the selector threshold;
+                    // return the output value from the first source module.
+                    return { Selection::Source0, T{ 0 } };
+                }
+            }
+            else
+            {
+                if (control_value < lower_bound || control_value > upper_bound)
+                    return { Selection::Source0, T{ 0 } };
+                else
+                    return { Selection::Source1, T{ 0 } };
+            }
+        }
     }
 
-    Module Billow(double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
+    template <typename T>
+    BasicModule<T>::BasicModule(Function function, BatchFunction batch_function)
+        : m_pfunctions{ std::make_shared<Functions const>(Functions{ std::move(function), std::move(batch_function) }) }
+    { }
+
+    template <typename T>
+    void BasicModule<T>::operator()(std::span<Position const> positions, std::span<T> values) const
     {
-        return [=](glm::dvec3 pos)
-        {
-            double value = 0.0;
-            double current_persistence = 1.0;
+        assert(values.size() >= positions.size());
+
+        m_pfunctions->Batch(positions, values);
+    }
 
-            pos *= frequency;
+    template <typename T>
+    void BasicModule<T>::operator()(Grid const& grid, std::span<T> values) const
+    {
+        std::vector<Position> positions{};
+        positions.reserve(grid.count());
 
-            for (int32_t current_octave = 0; static_cast<uint32_t>(current_octave) < octave_count; current_octave++)
+        // Positions are computed in double precision, so that float modules
+        // only lose precision in the samples, not in the grid spacing.
+        for (size_t z = 0; z < grid.Dims.z; z++)
+        {
+            for (size_t y = 0; y < grid.Dims.y; y++)
             {
-                // Get the coherent-noise value from the input value and add it to the final result.
-                int32_t octave_seed = (seed + current_octave) & INT32_MAX;
-                auto signal = gradient_coherent_noise_3d(pos, octave_seed, quality);
-                signal = 2.0 * glm::abs(signal) - 1.0;
-                value += signal * current_persistence;
-
-                // Prepare the next octave.
-                pos *= lacunarity;
-                current_persistence *= persistence;
+                for (size_t x = 0; x < grid.Dims.x; x++)
+                    positions.push_back(Position{ grid.Origin + glm::dvec3{ x, y, z } * grid.Step });
             }
-            value += 0.5;
+        }
 
-            return value;
-        };
+        (*this)(positions, values);
     }
 
-    Module Blend(Module source0, Module source1, Module control)
+    template <typename T>
+    BasicModule<T> Abs(BasicModule<T> source)
     {
-        return [=](glm::dvec3 pos)
+        return map_values(source, [](T value)
+        {
+            return glm::abs(value);
+        }).with_node(make_node<T>(graph::NodeType::Abs, {}, source));
+    }
+
+    template <typename T>
+    BasicModule<T> Add(BasicModule<T> source0, BasicModule<T> source1)
+    {
+        return combine_values(source0, source1, [](T value0, T value1)
+        {
+            return value0 + value1;
+        }).with_node(make_node<T>(graph::NodeType::Add, {}, source0, source1));
+    }
+
+    template <typename T>
+    BasicModule<T> Billow(double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
+    {
+        return expr::billow<T>(frequency, lacunarity, octave_count, persistence, quality, seed).type_erase();
+    }
+
+    template <typename T>
+    BasicModule<T> Blend(BasicModule<T> source0, BasicModule<T> source1, BasicModule<T> control)
+    {
+        auto blend = [=](Position<T> pos)
         {
             return glm::mix(source0(pos), source1(pos), control(pos));
         };
+
+        auto blend_batch = [=](std::span<Position<T> const> positions, std::span<T> values)
+        {
+            std::vector<T> values1(positions.size());
+            std::vector<T> control_values(positions.size());
+            source0(positions, values);
+            source1(positions, values1);
+            control(positions, control_values);
+
+            for (size_t i = 0; i < positions.size(); i++)
+                values[i] = glm::mix(values[i], values1[i], control_values[i]);
+        };
+
+        return BasicModule<T>{ blend, blend_batch }.with_node(make_node<T>(graph::NodeType::Blend, {}, source0, source1, control));
     }
 
-    Module Cache(Module source)
+    template <typename T>
+    BasicModule<T> Cache(BasicModule<T> source)
     {
-        return [=](glm::dvec3 pos)
+        static std::atomic<uint64_t> next_id{};
+        auto pid = std::make_shared<uint64_t const>(next_id++);
+
+        auto cache = [=](Position<T> pos)
         {
-            thread_local CacheEntry entry{};
-            if (pos == entry.pos)
-                return entry.val;
-            else
+            auto& entry = cache_entry<T>(pid);
+            if (!entry.HasValue || pos != entry.Pos)
             {
-                auto val = source(pos);
-                entry = {pos, val};
-                return val;
+                entry.Value = source(pos);
+                entry.Pos = pos;
+                entry.HasValue = true;
             }
+            return entry.Value;
         };
+
+        auto cache_batch = [=](std::span<Position<T> const> positions, std::span<T> values)
+        {
+            auto& entry = cache_entry<T>(pid);
+            if (std::ranges::equal(positions, entry.Positions))
+            {
+                std::ranges::copy(entry.Values, std::begin(values));
+                return;
+            }
+
+            source(positions, values);
+            entry.Positions.assign(std::begin(positions), std::end(positions));
+            entry.Values.assign(std::begin(values), std::begin(values) + positions.size());
+        };
+
+        return BasicModule<T>{ cache, cache_batch }.with_node(make_node<T>(graph::NodeType::Cache, {}, source));
     }
 
-    Module Cell(CellType type, double displacement, double frequency, bool enable_distance, double minkowsky_coefficient, int32_t seed)
+    template <typename T>
+    BasicModule<T> Cell(CellType type, double displacement, double frequency, bool enable_distance, double minkowsky_coefficient, int32_t seed)
     {
-        return [=](glm::dvec3 pos)
+        BasicModule<T> cell = [=](Position<T> pos)
         {
-            pos *= frequency;
+            pos *= static_cast<T>(frequency);
             auto ipos = glm::ivec3
             { 
                 pos.x > 0 ? static_cast<int32_t>(pos.x) : static_cast<int32_t>(pos.x) - 1,
@@ -123,8 +333,8 @@ namespace tarragon::noise
                 pos.z > 0 ? static_cast<int32_t>(pos.z) : static_cast<int32_t>(pos.z) - 1
             };
 
-            double minDistance = DBL_MAX;
-            glm::dvec3 candidate{};
+            T minDistance = std::numeric_limits<T>::max();
+            Position<T> candidate{};
 
             // Inside each unit cube, there is a seed point at a random position.  Go
             // through each of the nearby cubes until we find a cube with a seed point
@@ -137,16 +347,16 @@ namespace tarragon::noise
                     {
                         // Calculate the position and distance to the seed point inside of
                         // this unit cube.
-                        glm::dvec3 cube_ipos{xcur, ycur, zcur};
-                        glm::dvec3 cube_pos
+                        glm::ivec3 cube_ipos{xcur, ycur, zcur};
+                        Position<T> cube_pos
                         {
-                            xcur + value_noise_3d(cube_ipos, seed),
-                            ycur + value_noise_3d(cube_ipos, seed + 1),
-                            zcur + value_noise_3d(cube_ipos, seed + 2)
+                            static_cast<T>(xcur + value_noise_3d(cube_ipos, seed)),
+                            static_cast<T>(ycur + value_noise_3d(cube_ipos, seed + 1)),
+                            static_cast<T>(zcur + value_noise_3d(cube_ipos, seed + 2))
                         };
                         auto dist_vec = cube_pos - pos;
 
-                        double dist{};
+                        T dist{};
                         switch (type)
                         {
                             case CellType::Voronoi:
@@ -167,8 +377,9 @@ namespace tarragon::noise
 
                             case CellType::Minkowsky:
                             {
-                                auto dd = glm::pow(glm::abs(dist_vec), glm::dvec3{ minkowsky_coefficient });
-                                dist = std::pow(glm::compAdd(dd), 1.0 / minkowsky_coefficient);
+                                auto coefficient = static_cast<T>(minkowsky_coefficient);
+                                auto dd = glm::pow(glm::abs(dist_vec), Position<T>{ coefficient });
+                                dist = std::pow(glm::compAdd(dd), T{ 1 } / coefficient);
                                 break;
                             }
                         }
@@ -183,60 +394,74 @@ namespace tarragon::noise
                 }
             }
 
-            double value{};
+            T value{};
             if (enable_distance)
             {
                 // Determine the distance to the nearest seed point.
-                value = glm::distance(candidate, pos) * glm::root_three<double>() - 1.0;
+                value = glm::distance(candidate, pos) * glm::root_three<T>() - T{ 1 };
             }
 
             // Return the calculated distance with the displacement value applied.
-            return value + (displacement * value_noise_3d(glm::ivec3{ glm::floor(candidate) }));
+            return value + static_cast<T>(displacement * value_noise_3d(glm::ivec3{ glm::floor(candidate) }));
         };
+
+        return cell.with_node(make_node<T>(graph::NodeType::Cell, parameters(type, displacement, frequency, enable_distance, minkowsky_coefficient, seed)));
     }
 
-    Module Checkerboard()
+    template <typename T>
+    BasicModule<T> Checkerboard()
     {
-        return [=](glm::dvec3 pos)
+        BasicModule<T> checkerboard = [=](Position<T> pos)
         {
             glm::ivec3 ipos{ glm::floor(pos) };
             auto ipos1 = ipos & 1;
-            return (ipos1.x ^ ipos1.y ^ ipos1.z) != 0 ? -1.0 : 1.0;
+            return (ipos1.x ^ ipos1.y ^ ipos1.z) != 0 ? T{ -1 } : T{ 1 };
         };
+
+        return checkerboard.with_node(make_node<T>(graph::NodeType::Checkerboard, {}));
     }
 
-    Module Clamp(Module source, double lower_bound, double upper_bound)
+    template <typename T>
+    BasicModule<T> Clamp(BasicModule<T> source, double lower_bound, double upper_bound)
     {
-        return [=](glm::dvec3 pos)
+        return map_values(source, [lower_bound = static_cast<T>(lower_bound), upper_bound = static_cast<T>(upper_bound)](T value)
         {
-            return glm::clamp(source(pos), lower_bound, upper_bound);
-        };
+            return glm::clamp(value, lower_bound, upper_bound);
+        }).with_node(make_node<T>(graph::NodeType::Clamp, parameters(lower_bound, upper_bound), source));
     }
 
-    Module Constant(double value)
+    template <typename T>
+    BasicModule<T> Constant(double value)
     {
-        return [=](glm::dvec3 pos)
+        BasicModule<T> constant = [value = static_cast<T>(value)](Position<T> pos)
         {
             UNUSED_PARAM(pos);
 
             return value;
         };
+
+        return constant.with_node(make_node<T>(graph::NodeType::Constant, parameters(value)));
     }
 
-    Module Curve(Module source, ControlPoint const* control_points, size_t control_point_count)
+    template <typename T>
+    BasicModule<T> Curve(BasicModule<T> source, ControlPoint const* control_points, size_t control_point_count)
     {
         assert(control_points != nullptr);
         assert(control_point_count >= 4);
 
+        std::vector<double> parameter_vec{};
+        for (auto const& control_point : std::span{ control_points, control_point_count })
+        {
+            parameter_vec.push_back(control_point.Input);
+            parameter_vec.push_back(control_point.Output);
+        }
+
         std::vector<ControlPoint> sorted_control_points{control_points, control_points + control_point_count };
         std::sort(std::begin(sorted_control_points), std::end(sorted_control_points),
             [](auto& a, auto& b) { return a.Input < b.Input; });
 
-        return [source, sorted_control_points](glm::dvec3 pos)
+        return map_values(source, [sorted_control_points](T source_value)
         {
-            // Get the output value from the source module.
-            auto source_value = source(pos);
-
             // Find the first element in the control point array that has an input value
             // larger than the output value from the source module.
             int32_t index_pos{};
@@ -258,170 +483,134 @@ namespace tarragon::noise
             // smallest input value of the control point array), get the corresponding
             // output value of the nearest control point and exit now.
             if (index1 == index2)
-                return sorted_control_points.at(index1).Output;
+                return static_cast<T>(sorted_control_points.at(index1).Output);
 
             // Compute the alpha value used for cubic interpolation.
             auto input0 = sorted_control_points.at(index1).Input;
             auto input1 = sorted_control_points.at(index2).Input;
             auto alpha = (source_value - input0) / (input1 - input0);
 
-            return glm::cubic(
+            return static_cast<T>(glm::cubic(
                 glm::dvec1{ sorted_control_points.at(index0).Output },
                 glm::dvec1{ sorted_control_points.at(index1).Output },
                 glm::dvec1{ sorted_control_points.at(index2).Output },
                 glm::dvec1{ sorted_control_points.at(index3).Output },
-                alpha).x;
-        };
+                alpha).x);
+        }).with_node(make_node<T>(graph::NodeType::Curve, std::move(parameter_vec), source));
     }
 
-    Module Cylinders(double frequency)
+    template <typename T>
+    BasicModule<T> Cylinders(double frequency)
     {
-        return [=](glm::dvec3 pos)
+        BasicModule<T> cylinders = [=](Position<T> pos)
         {
-            pos.x *= frequency;
-            pos.y *= frequency;
+            pos.x *= static_cast<T>(frequency);
+            pos.y *= static_cast<T>(frequency);
 
-            auto center_dist = glm::length(glm::dvec2{ pos });
+            auto center_dist = glm::length(glm::vec<2, T>{ pos });
             auto inner_sphere_dist = center_dist - glm::floor(center_dist);
-            auto outer_sphere_dist = 1.0 - inner_sphere_dist;
+            auto outer_sphere_dist = T{ 1 } - inner_sphere_dist;
             auto nearest_dist = glm::min(inner_sphere_dist, outer_sphere_dist);
-            return 1.0 - (nearest_dist * 4.0); // Puts it in the -1.0 to +1.0 range.
+            return T{ 1 } - (nearest_dist * T{ 4 }); // Puts it in the -1.0 to +1.0 range.
         };
+
+        return cylinders.with_node(make_node<T>(graph::NodeType::Cylinders, parameters(frequency)));
     }
 
-    Module Displace(Module source, Module xdisplace, Module ydisplace, Module zdisplace)
+    template <typename T>
+    BasicModule<T> Displace(BasicModule<T> source, BasicModule<T> xdisplace, BasicModule<T> ydisplace, BasicModule<T> zdisplace)
     {
-        return [=](glm::dvec3 pos)
+        auto displace = [=](Position<T> pos)
         {
             auto displaced_pos = pos +
-                glm::dvec3{ xdisplace(pos), ydisplace(pos), zdisplace(pos) };
+                Position<T>{ xdisplace(pos), ydisplace(pos), zdisplace(pos) };
             return source(displaced_pos);
         };
-    }
 
-    Module Exponent(Module source, double exponent)
-    {
-        return [=](glm::dvec3 pos)
+        auto displace_batch = [=](std::span<Position<T> const> positions, std::span<T> values)
         {
-            auto value = source(pos);
-            return glm::pow(glm::abs((value + 1) / 2), exponent) * 2 - 1;
+            std::vector<T> xvalues(positions.size()), yvalues(positions.size()), zvalues(positions.size());
+            xdisplace(positions, xvalues);
+            ydisplace(positions, yvalues);
+            zdisplace(positions, zvalues);
+
+            std::vector<Position<T>> displaced_positions(positions.size());
+            for (size_t i = 0; i < positions.size(); i++)
+                displaced_positions[i] = positions[i] + Position<T>{ xvalues[i], yvalues[i], zvalues[i] };
+            source(displaced_positions, values);
         };
+
+        return BasicModule<T>{ displace, displace_batch }.with_node(make_node<T>(graph::NodeType::Displace, {}, source, xdisplace, ydisplace, zdisplace));
     }
 
-    Module Multiply(Module source0, Module source1)
+    template <typename T>
+    BasicModule<T> Exponent(BasicModule<T> source, double exponent)
     {
-        return [=](glm::dvec3 pos)
+        return map_values(source, [exponent = static_cast<T>(exponent)](T value)
         {
-            return source0(pos) * source1(pos);
-        };
+            return glm::pow(glm::abs((value + 1) / 2), exponent) * 2 - 1;
+        }).with_node(make_node<T>(graph::NodeType::Exponent, parameters(exponent), source));
     }
 
-    Module Invert(Module source)
+    template <typename T>
+    BasicModule<T> Multiply(BasicModule<T> source0, BasicModule<T> source1)
     {
-        return [=](glm::dvec3 pos)
+        return combine_values(source0, source1, [](T value0, T value1)
         {
-            return -1.0 * source(pos);
-        };
+            return value0 * value1;
+        }).with_node(make_node<T>(graph::NodeType::Multiply, {}, source0, source1));
     }
 
-    Module Max(Module source0, Module source1)
+    template <typename T>
+    BasicModule<T> Invert(BasicModule<T> source)
     {
-        return [=](glm::dvec3 pos)
+        return map_values(source, [](T value)
         {
-            return glm::max(source0(pos), source1(pos));
-        };
-        
+            return T{ -1 } * value;
+        }).with_node(make_node<T>(graph::NodeType::Invert, {}, source));
     }
 
-    Module Min(Module source0, Module source1)
+    template <typename T>
+    BasicModule<T> Max(BasicModule<T> source0, BasicModule<T> source1)
     {
-        return [=](glm::dvec3 pos)
+        return combine_values(source0, source1, [](T value0, T value1)
         {
-            return glm::min(source0(pos), source1(pos));
-        };
+            return glm::max(value0, value1);
+        }).with_node(make_node<T>(graph::NodeType::Max, {}, source0, source1));
     }
 
-    Module Perlin(double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
+    template <typename T>
+    BasicModule<T> Min(BasicModule<T> source0, BasicModule<T> source1)
     {
-        return [=](glm::dvec3 pos)
+        return combine_values(source0, source1, [](T value0, T value1)
         {
-            double value{};
-            double current_persistence = 1.0;
-
-            pos *= frequency;
-
-            for (int32_t octave = 0; static_cast<uint32_t>(octave) < octave_count; octave++)
-            {
-                int32_t octave_seed = (seed + octave) & INT32_MAX;
-                auto signal = gradient_coherent_noise_3d(pos, octave_seed, quality);
-                value += signal * current_persistence;
-
-                pos *= lacunarity;
-                current_persistence *= persistence;
-            }
-
-            return value;
-        };
+            return glm::min(value0, value1);
+        }).with_node(make_node<T>(graph::NodeType::Min, {}, source0, source1));
     }
 
-    Module Power(Module source0, Module source1)
+    template <typename T>
+    BasicModule<T> Perlin(double frequency, double lacunarity, uint32_t octave_count, double persistence, NoiseQuality quality, int32_t seed)
     {
-        return [=](glm::dvec3 pos)
-        {
-            return glm::pow(source0(pos), source1(pos));
-        };
+        return expr::perlin<T>(frequency, lacunarity, octave_count, persistence, quality, seed).type_erase();
     }
 
-    Module RidgedMulti(double frequency, double lacunarity, uint32_t octave_count, NoiseQuality quality, int32_t seed)
+    template <typename T>
+    BasicModule<T> Power(BasicModule<T> source0, BasicModule<T> source1)
     {
-        assert(octave_count <= RidgedMultiMaxOctaveCount);
-
-        auto spectral_weights = calc_ridgedmulti_spectral_weights(lacunarity);
-        const double offset = 1.0;
-        const double gain = 2.0;
-
-        return [=](glm::dvec3 pos)
+        return combine_values(source0, source1, [](T value0, T value1)
         {
-            double value{};
-            double weight = 1.0;
-
-            pos *= frequency;
-
-            for (int32_t octave = 0; static_cast<uint32_t>(octave) < octave_count; octave++)
-            {
-                // Get the coherent-noise value.
-                int32_t octave_seed = (seed + octave) & 0x7fffffff;
-                auto signal = gradient_coherent_noise_3d(pos, octave_seed, quality);
-
-                // Make the ridges.
-                signal = offset - glm::abs(signal);
-
-                // Square the signal to increase the sharpness of the ridges.
-                signal *= signal;
-
-                // The weighting from the previous octave is applied to the signal.
-                // Larger values have higher weights, producing sharp points along the
-                // ridges.
-                signal *= weight;
-
-                // Weight successive contributions by the previous signal.
-                weight = signal * gain;
-                if (weight > 1.0)
-                    weight = 1.0;
-                if (weight < 0.0)
-                    weight = 0.0;
-
-                // Add the signal to the output value.
-                value += (signal * spectral_weights[octave]);
-
-                pos *= lacunarity;
-            }
+            return glm::pow(value0, value1);
+        }).with_node(make_node<T>(graph::NodeType::Power, {}, source0, source1));
+    }
 
-            return (value * 1.25) - 1.0;
-        };
+    template <typename T>
+    BasicModule<T> RidgedMulti(double frequency, double lacunarity, uint32_t octave_count, NoiseQuality quality, int32_t seed)
+    {
+        return expr::ridged_multi<T>(frequency, lacunarity, octave_count, quality, seed).type_erase();
     }
 
-    Module Rotate(Module source, double xdegrees, double ydegrees, double zdegrees)
+    template <typename T>
+    BasicModule<T> Rotate(BasicModule<T> source, double xdegrees, double ydegrees, double zdegrees)
     {
         constexpr glm::dquat quat_id = glm::identity<glm::quat>();
 
@@ -429,117 +618,137 @@ namespace tarragon::noise
         auto qy = glm::rotate(quat_id, glm::radians(ydegrees), glm::dvec3{ 0.0, 1.0, 0.0 });
         auto qz = glm::rotate(quat_id, glm::radians(zdegrees), glm::dvec3{ 0.0, 0.0, 1.0 });
 
-        auto rotation = qx * qy * qz;
+        glm::qua<T> rotation{ qx * qy * qz };
 
-        return [source, rotation](glm::dvec3 pos)
+        return map_positions(source, [rotation](Position<T> pos)
         {
-            auto rotated_pos = rotation * pos;
-            return source(rotated_pos);
-        };
+            return rotation * pos;
+        }).with_node(make_node<T>(graph::NodeType::Rotate, parameters(xdegrees, ydegrees, zdegrees), source));
     }
 
-    Module ScaleBias(Module source, double scale, double bias)
+    template <typename T>
+    BasicModule<T> ScaleBias(BasicModule<T> source, double scale, double bias)
     {
-        return [=](glm::dvec3 pos)
+        return map_values(source, [scale = static_cast<T>(scale), bias = static_cast<T>(bias)](T value)
         {
-            return source(pos) * scale + bias;
-        };
+            return value * scale + bias;
+        }).with_node(make_node<T>(graph::NodeType::ScaleBias, parameters(scale, bias), source));
     }
 
-    Module ScalePoint(Module source, glm::dvec3 const& scale_factor)
+    template <typename T>
+    BasicModule<T> ScalePoint(BasicModule<T> source, glm::dvec3 const& scale_factor)
     {
-        return [=](glm::dvec3 pos)
+        return map_positions(source, [scale_factor = Position<T>{ scale_factor }](Position<T> pos)
         {
-            return source(pos * scale_factor);
-        };
+            return pos * scale_factor;
+        }).with_node(make_node<T>(graph::NodeType::ScalePoint, parameters(scale_factor.x, scale_factor.y, scale_factor.z), source));
     }
 
-    Module Select(Module source0, Module source1, Module control,
+    template <typename T>
+    BasicModule<T> Select(BasicModule<T> source0, BasicModule<T> source1, BasicModule<T> control,
         double lower_bound, double upper_bound, double edge_falloff)
     {
-        return [=](glm::dvec3 pos)
+        auto select = [=](Position<T> pos)
         {
-            auto control_value = control(pos);
-            if (edge_falloff > 0.0)
+            auto [selected, alpha] = select_sources(control(pos),
+                static_cast<T>(lower_bound), static_cast<T>(upper_bound), static_cast<T>(edge_falloff));
+            switch (selected)
             {
-                if (control_value < (lower_bound - edge_falloff))
-                {
-                    // The output value from the control module is below the selector
-                    // threshold; return the output value from the first source module.
+                case Selection::Source0:
                     return source0(pos);
-                }
-                else if (control_value < (lower_bound + edge_falloff))
-                {
-                    // The output value from the control module is near the lower end of the
-                    // selector threshold and within the smooth curve. Interpolate between
-                    // the output values from the first and second source modules.
-                    auto lower_curve = lower_bound - edge_falloff;
-                    auto upper_curve = lower_bound + edge_falloff;
-                    auto alpha = scurve3((control_value - lower_curve) / (upper_curve / lower_curve));
-                    return glm::mix(source0(pos), source1(pos), alpha);
-                }
-                else if (control_value < (upper_bound - edge_falloff))
-                {
-                    // The output value from the control module is within the selector
-                    // threshold; return the output value from the second source module.
+                case Selection::Source1:
                     return source1(pos);
-                }
-                else if (control_value < (upper_bound + edge_falloff))
-                {
-                    // The output value from the control module is near the upper end of the
-                    // selector threshold and within the smooth curve. Interpolate between
-                    // the output values from the first and second source modules.
-                    auto lower_curve = upper_bound - edge_falloff;
-                    auto upper_curve = upper_bound + edge_falloff;
-                    auto alpha = scurve3((control_value - lower_curve) / (upper_curve / lower_curve));
+                case Selection::LowerEdge:
+                    return glm::mix(source0(pos), source1(pos), alpha);
+                case Selection::UpperEdge:
                     return glm::mix(source1(pos), source0(pos), alpha);
-                }
-                else
-                {
-                    // Output value from the control module is above the selector threshold;
-                    // return the output value from the first source module.
-                    return source0(pos);
-                }
             }
-            else
+            return T{ 0 };
+        };
+
+        auto select_batch = [=](std::span<Position<T> const> positions, std::span<T> values)
+        {
+            std::vector<T> control_values(positions.size());
+            control(positions, control_values);
+
+            // Only evaluate each source module for the positions that need its value.
+            std::vector<SelectResult<T>> results(positions.size());
+            std::vector<Position<T>> positions0{}, positions1{};
+            for (size_t i = 0; i < positions.size(); i++)
             {
-                if (control_value < lower_bound || control_value > upper_bound)
-                    return source0(pos);
-                else
-                    return source1(pos);
+                results[i] = select_sources(control_values[i],
+                    static_cast<T>(lower_bound), static_cast<T>(upper_bound), static_cast<T>(edge_falloff));
+                if (results[i].Selected != Selection::Source1)
+                    positions0.push_back(positions[i]);
+                if (results[i].Selected != Selection::Source0)
+                    positions1.push_back(positions[i]);
+            }
+
+            std::vector<T> values0(positions0.size()), values1(positions1.size());
+            source0(positions0, values0);
+            source1(positions1, values1);
+
+            size_t index0{}, index1{};
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                auto [selected, alpha] = results[i];
+                switch (selected)
+                {
+                    case Selection::Source0:
+                        values[i] = values0[index0++];
+                        break;
+                    case Selection::Source1:
+                        values[i] = values1[index1++];
+                        break;
+                    case Selection::LowerEdge:
+                        values[i] = glm::mix(values0[index0++], values1[index1++], alpha);
+                        break;
+                    case Selection::UpperEdge:
+                        values[i] = glm::mix(values1[index1++], values0[index0++], alpha);
+                        break;
+                }
             }
         };
+
+        return BasicModule<T>{ select, select_batch }.with_node(make_node<T>(graph::NodeType::Select, parameters(lower_bound, upper_bound, edge_falloff), source0, source1, control));
     }
 
-    Module Spheres(double frequency)
+    template <typename T>
+    BasicModule<T> Spheres(double frequency)
     {
-        return [=](glm::dvec3 pos)
+        BasicModule<T> spheres = [=](Position<T> pos)
         {
-            pos *= frequency;
+            pos *= static_cast<T>(frequency);
 
             auto center_dist = glm::length(pos);
             auto inner_sphere_dist = center_dist - glm::floor(center_dist);
-            auto outer_sphere_dist = 1.0 - inner_sphere_dist;
+            auto outer_sphere_dist = T{ 1 } - inner_sphere_dist;
             auto nearest_dist = glm::min(inner_sphere_dist, outer_sphere_dist);
-            return 1.0 - (nearest_dist * 4.0); // Puts it in the -1.0 to +1.0 range.
+            return T{ 1 } - (nearest_dist * T{ 4 }); // Puts it in the -1.0 to +1.0 range.
         };
+
+        return spheres.with_node(make_node<T>(graph::NodeType::Spheres, parameters(frequency)));
     }
 
-    Module Terrace(Module source, double const* control_points, size_t control_point_count, bool invert_terraces)
+    template <typename T>
+    BasicModule<T> Terrace(BasicModule<T> source, double const* control_points, size_t control_point_count, bool invert_terraces)
     {
         assert(control_points != nullptr);
         assert(control_point_count >= 2);
 
-        std::vector<double> control_point_vec{ control_points, control_points + control_point_count };
+        auto parameter_vec = parameters(invert_terraces);
+        parameter_vec.insert(std::end(parameter_vec), control_points, control_points + control_point_count);
 
-        return [source, control_point_vec, invert_terraces](glm::dvec3 pos)
-        {
-            auto source_value = source(pos);
+        std::vector<T> control_point_vec(control_point_count);
+        std::transform(control_points, control_points + control_point_count, std::begin(control_point_vec),
+            [](double control_point) { return static_cast<T>(control_point); });
 
+        return map_values(source, [control_point_vec, invert_terraces](T source_value)
+        {
             // Find the first element in the control point array that has a value
             // larger than the output value from the source module.
-            size_t index{};
-            for (index = 0; index < control_point_vec.size(); index++)
+            int32_t index{};
+            for (index = 0; static_cast<size_t>(index) < control_point_vec.size(); index++)
             {
                 if (source_value < control_point_vec.at(index))
                     break;
@@ -547,8 +756,8 @@ namespace tarragon::noise
 
             // Find the two nearest control points so that we can map their values
             // onto a quadratic curve.
-            auto index0 = glm::clamp(index - 1, 0ull, control_point_vec.size() - 1);
-            auto index1 = glm::clamp(index, 0ull, control_point_vec.size() - 1);
+            auto index0 = glm::clamp(index - 1, 0, static_cast<int32_t>(control_point_vec.size() - 1));
+            auto index1 = glm::clamp(index, 0, static_cast<int32_t>(control_point_vec.size() - 1));
 
             // If some control points are missing (which occurs if the output value from
             // the source module is greater than the largest value or less than the
@@ -563,7 +772,7 @@ namespace tarragon::noise
             auto alpha = (source_value - value0) / (value1 - value0);
             if (invert_terraces)
             {
-                alpha = 1.0 - alpha;
+                alpha = T{ 1 } - alpha;
                 std::swap(value0, value1);
             }
 
@@ -572,28 +781,30 @@ namespace tarragon::noise
 
             // Now perform the linear interpolation given the alpha value.
             return glm::mix(value0, value1, alpha);
-        };
+        }).with_node(make_node<T>(graph::NodeType::Terrace, std::move(parameter_vec), source));
     }
 
-    Module TranslatePoint(Module source, glm::dvec3 const& translation)
+    template <typename T>
+    BasicModule<T> TranslatePoint(BasicModule<T> source, glm::dvec3 const& translation)
     {
-        return [=](glm::dvec3 pos)
+        return map_positions(source, [translation = Position<T>{ translation }](Position<T> pos)
         {
-            return source(pos + translation);
-        };
+            return pos + translation;
+        }).with_node(make_node<T>(graph::NodeType::TranslatePoint, parameters(translation.x, translation.y, translation.z), source));
     }
 
-    Module Turbulence(Module source, double frequency, double power, uint32_t roughness, int32_t seed)
+    template <typename T>
+    BasicModule<T> Turbulence(BasicModule<T> source, double frequency, double power, uint32_t roughness, int32_t seed)
     {
-        auto xdistort = Perlin(frequency, PerlinDefaultLacunarity, roughness, PerlinDefaultPersistence, DefaultQuality, seed);
-        auto ydistort = Perlin(frequency, PerlinDefaultLacunarity, roughness, PerlinDefaultPersistence, DefaultQuality, seed + 1);
-        auto zdistort = Perlin(frequency, PerlinDefaultLacunarity, roughness, PerlinDefaultPersistence, DefaultQuality, seed + 2);
+        auto xdistort = Perlin<T>(frequency, PerlinDefaultLacunarity, roughness, PerlinDefaultPersistence, DefaultQuality, seed);
+        auto ydistort = Perlin<T>(frequency, PerlinDefaultLacunarity, roughness, PerlinDefaultPersistence, DefaultQuality, seed + 1);
+        auto zdistort = Perlin<T>(frequency, PerlinDefaultLacunarity, roughness, PerlinDefaultPersistence, DefaultQuality, seed + 2);
         
-        static constexpr glm::dvec3 offset0{ 12414.0 / 65536.0, 65124.0 / 65536.0, 31337.0 / 65536.0 };
-        static constexpr glm::dvec3 offset1{ 26519.0 / 65536.0, 18128.0 / 65536.0, 60493.0 / 65536.0 };
-        static constexpr glm::dvec3 offset2{ 53820.0 / 65536.0, 11213.0 / 65536.0, 44845.0 / 65536.0 };
+        static constexpr Position<T> offset0{ 12414.0 / 65536.0, 65124.0 / 65536.0, 31337.0 / 65536.0 };
+        static constexpr Position<T> offset1{ 26519.0 / 65536.0, 18128.0 / 65536.0, 60493.0 / 65536.0 };
+        static constexpr Position<T> offset2{ 53820.0 / 65536.0, 11213.0 / 65536.0, 44845.0 / 65536.0 };
 
-        return [=](glm::dvec3 pos)
+        auto turbulence = [=, power = static_cast<T>(power)](Position<T> pos)
         {
             // Get the values from the three Perlin noise modules and
             // add each value to each coordinate of the input value. There are also
@@ -602,17 +813,80 @@ namespace tarragon::noise
             // when multiplied by the frequency, are near an integer boundary. This is
             // due to a property of gradient coherent noise, which returns zero at
             // integer boundaries.
-            glm::dvec3 pos0{ pos + offset0 }, pos1{ pos + offset1 }, pos2{ pos + offset2 };
-            glm::dvec3 distorted_pos = pos + power * glm::dvec3{ xdistort(pos0), ydistort(pos1), zdistort(pos2) };
+            Position<T> pos0{ pos + offset0 }, pos1{ pos + offset1 }, pos2{ pos + offset2 };
+            Position<T> distorted_pos = pos + power * Position<T>{ xdistort(pos0), ydistort(pos1), zdistort(pos2) };
             return source(distorted_pos);
         };
+
+        auto turbulence_batch = [=, power = static_cast<T>(power)](std::span<Position<T> const> positions, std::span<T> values)
+        {
+            std::vector<Position<T>> offset_positions(positions.size());
+            std::vector<T> xvalues(positions.size()), yvalues(positions.size()), zvalues(positions.size());
+
+            for (size_t i = 0; i < positions.size(); i++)
+                offset_positions[i] = positions[i] + offset0;
+            xdistort(offset_positions, xvalues);
+            for (size_t i = 0; i < positions.size(); i++)
+                offset_positions[i] = positions[i] + offset1;
+            ydistort(offset_positions, yvalues);
+            for (size_t i = 0; i < positions.size(); i++)
+                offset_positions[i] = positions[i] + offset2;
+            zdistort(offset_positions, zvalues);
+
+            std::vector<Position<T>>& distorted_positions = offset_positions;
+            for (size_t i = 0; i < positions.size(); i++)
+                distorted_positions[i] = positions[i] + power * Position<T>{ xvalues[i], yvalues[i], zvalues[i] };
+            source(distorted_positions, values);
+        };
+
+        return BasicModule<T>{ turbulence, turbulence_batch }.with_node(make_node<T>(graph::NodeType::Turbulence, parameters(frequency, power, roughness, seed), source));
     }
 
-    Module White(int32_t scale, int32_t seed)
+    template <typename T>
+    BasicModule<T> White(int32_t scale, int32_t seed)
     {
-        return [=](glm::dvec3 pos)
+        BasicModule<T> white = [=](Position<T> pos)
         {
-            return value_noise_3d(glm::ivec3{ pos * static_cast<double>(scale) }, seed);
+            return static_cast<T>(value_noise_3d(glm::ivec3{ pos * static_cast<T>(scale) }, seed));
         };
+
+        return white.with_node(make_node<T>(graph::NodeType::White, parameters(scale, seed)));
     }
+
+#define TARRAGON_NOISE_INSTANTIATE_MODULES(T) \
+    template class BasicModule<T>; \
+    template BasicModule<T> Abs(BasicModule<T>); \
+    template BasicModule<T> Add(BasicModule<T>, BasicModule<T>); \
+    template BasicModule<T> Billow<T>(double, double, uint32_t, double, NoiseQuality, int32_t); \
+    template BasicModule<T> Blend(BasicModule<T>, BasicModule<T>, BasicModule<T>); \
+    template BasicModule<T> Cache(BasicModule<T>); \
+    template BasicModule<T> Cell<T>(CellType, double, double, bool, double, int32_t); \
+    template BasicModule<T> Checkerboard<T>(); \
+    template BasicModule<T> Clamp(BasicModule<T>, double, double); \
+    template BasicModule<T> Constant<T>(double); \
+    template BasicModule<T> Curve(BasicModule<T>, ControlPoint const*, size_t); \
+    template BasicModule<T> Cylinders<T>(double); \
+    template BasicModule<T> Displace(BasicModule<T>, BasicModule<T>, BasicModule<T>, BasicModule<T>); \
+    template BasicModule<T> Exponent(BasicModule<T>, double); \
+    template BasicModule<T> Invert(BasicModule<T>); \
+    template BasicModule<T> Max(BasicModule<T>, BasicModule<T>); \
+    template BasicModule<T> Min(BasicModule<T>, BasicModule<T>); \
+    template BasicModule<T> Multiply(BasicModule<T>, BasicModule<T>); \
+    template BasicModule<T> Perlin<T>(double, double, uint32_t, double, NoiseQuality, int32_t); \
+    template BasicModule<T> Power(BasicModule<T>, BasicModule<T>); \
+    template BasicModule<T> RidgedMulti<T>(double, double, uint32_t, NoiseQuality, int32_t); \
+    template BasicModule<T> Rotate(BasicModule<T>, double, double, double); \
+    template BasicModule<T> ScaleBias(BasicModule<T>, double, double); \
+    template BasicModule<T> ScalePoint(BasicModule<T>, glm::dvec3 const&); \
+    template BasicModule<T> Select(BasicModule<T>, BasicModule<T>, BasicModule<T>, double, double, double); \
+    template BasicModule<T> Spheres<T>(double); \
+    template BasicModule<T> Terrace(BasicModule<T>, double const*, size_t, bool); \
+    template BasicModule<T> TranslatePoint(BasicModule<T>, glm::dvec3 const&); \
+    template BasicModule<T> Turbulence(BasicModule<T>, double, double, uint32_t, int32_t); \
+    template BasicModule<T> White<T>(int32_t, int32_t);
+
+    TARRAGON_NOISE_INSTANTIATE_MODULES(float)
+    TARRAGON_NOISE_INSTANTIATE_MODULES(double)
+
+#undef TARRAGON_NOISE_INSTANTIATE_MODULES
 }
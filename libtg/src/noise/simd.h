@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <glm/vec3.hpp>
+
+#include "noise/common.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TARRAGON_NOISE_X86 1
+#else
+#define TARRAGON_NOISE_X86 0
+#endif
+
+// Vectorized noise kernels
+//
+// Each kernel lives in its own translation unit, compiled for its instruction
+// set, and is only called after the CPU was checked to support it.
+// The kernels evaluate as many positions as fit their lane width and return
+// the number of positions processed; the caller handles the remainder.
+// Results are bit-identical to the scalar functions in generator.cpp.
+namespace tarragon::noise::simd
+{
+    enum class InstructionSet
+    {
+        Scalar,
+        SSE41,
+        AVX2,
+    };
+
+    // Gets the best instruction set supported by the CPU
+    InstructionSet detect_instruction_set();
+
+    size_t gradient_coherent_noise_3d_sse41(std::span<glm::dvec3 const> positions, std::span<double> values, int32_t seed, NoiseQuality quality);
+    size_t gradient_coherent_noise_3d_sse41(std::span<glm::vec3 const> positions, std::span<float> values, int32_t seed, NoiseQuality quality);
+    size_t gradient_coherent_noise_3d_avx2(std::span<glm::dvec3 const> positions, std::span<double> values, int32_t seed, NoiseQuality quality);
+    size_t gradient_coherent_noise_3d_avx2(std::span<glm::vec3 const> positions, std::span<float> values, int32_t seed, NoiseQuality quality);
+}
@@ -0,0 +1,100 @@
+#include "rangeallocator.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace tarragon
+{
+    RangeAllocator::RangeAllocator(size_t capacity)
+        : m_capacity{ capacity }
+    {
+        if (capacity > 0)
+            insert_free(0, capacity);
+    }
+
+    void RangeAllocator::insert_free(size_t offset, size_t size)
+    {
+        m_free_by_offset.emplace(offset, size);
+        m_free_by_size.emplace(size, offset);
+    }
+
+    void RangeAllocator::erase_free(std::map<size_t, size_t>::iterator it)
+    {
+        auto [first, last] = m_free_by_size.equal_range(it->second);
+        for (auto size_it = first; size_it != last; size_it++)
+        {
+            if (size_it->second == it->first)
+            {
+                m_free_by_size.erase(size_it);
+                break;
+            }
+        }
+        m_free_by_offset.erase(it);
+    }
+
+    std::optional<size_t> RangeAllocator::allocate(size_t size)
+    {
+        if (size == 0)
+            return {};
+
+        auto size_it = m_free_by_size.lower_bound(size);
+        if (size_it == std::end(m_free_by_size))
+            return {};
+
+        auto [free_size, offset] = *size_it;
+        erase_free(m_free_by_offset.find(offset));
+        if (free_size > size)
+            insert_free(offset + size, free_size - size);
+
+        m_allocated += size;
+        return offset;
+    }
+
+    void RangeAllocator::free(size_t offset, size_t size)
+    {
+        assert(size > 0 && offset + size <= m_capacity);
+        assert(m_allocated >= size);
+
+        m_allocated -= size;
+
+        // Merge with the free ranges right after and right before
+        auto next = m_free_by_offset.lower_bound(offset);
+        assert(next == std::end(m_free_by_offset) || next->first >= offset + size);
+        if (next != std::end(m_free_by_offset) && next->first == offset + size)
+        {
+            size += next->second;
+            auto erased = next++;
+            erase_free(erased);
+        }
+
+        if (next != std::begin(m_free_by_offset))
+        {
+            auto prev = std::prev(next);
+            assert(prev->first + prev->second <= offset);
+            if (prev->first + prev->second == offset)
+            {
+                offset = prev->first;
+                size += prev->second;
+                erase_free(prev);
+            }
+        }
+
+        insert_free(offset, size);
+    }
+
+    void RangeAllocator::grow(size_t capacity)
+    {
+        assert(capacity >= m_capacity);
+        if (capacity == m_capacity)
+            return;
+
+        auto added = capacity - m_capacity;
+        auto offset = m_capacity;
+        m_capacity = capacity;
+
+        // The new elements are allocated and freed, to merge with a free
+        // range at the old end
+        m_allocated += added;
+        free(offset, added);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+namespace tarragon::bench
+{
+    inline volatile double sink{};
+
+    // Runs f repeatedly and prints the mean time per run
+    //
+    // f returns a value derived from its work, so that the compiler can't
+    // optimize the work away.
+    template <typename F>
+    void run(std::string_view name, size_t iterations, F&& f)
+    {
+        // Warm up caches and lazily initialized state.
+        sink = static_cast<double>(f());
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+            sink = static_cast<double>(f());
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+        std::printf("%-56.*s %12.2f us\n", static_cast<int>(name.size()), name.data(), elapsed.count() / iterations);
+    }
+
+    void noise_benchmarks();
+    void queue_benchmarks();
+    void mesh_benchmarks();
+    void grid_benchmarks();
+    void cache_benchmarks();
+}
@@ -0,0 +1,134 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <flathashmap.h>
+
+#include "chunk.h"
+#include "chunkcache.h"
+
+namespace tarragon::bench
+{
+    namespace
+    {
+        // A 50 x 50 x 40 block of chunks, 100k of them
+        std::vector<ChunkIndex> chunk_indices()
+        {
+            std::vector<ChunkIndex> indices{};
+            for (int64_t z = -20; z < 20; z++)
+            {
+                for (int64_t y = -25; y < 25; y++)
+                {
+                    for (int64_t x = -25; x < 25; x++)
+                        indices.push_back(ChunkIndex{ x, y, z });
+                }
+            }
+            return indices;
+        }
+    }
+
+    void cache_benchmarks()
+    {
+        constexpr size_t Iterations = 10;
+
+        auto indices = chunk_indices();
+        // Look up in a different order than inserted
+        auto lookups = indices;
+        std::shuffle(std::begin(lookups), std::end(lookups), std::mt19937{ 42 });
+        auto suffix = std::to_string(indices.size()) + " chunks";
+
+        run("cache: insert, std::unordered_map, " + suffix, Iterations, [&]
+        {
+            std::unordered_map<ChunkIndex, size_t, ChunkIndexHash> map{};
+            for (size_t i = 0; i < indices.size(); i++)
+                map.try_emplace(indices[i], i);
+            return map.size();
+        });
+
+        run("cache: insert, flat, " + suffix, Iterations, [&]
+        {
+            FlatHashMap<ChunkIndex, size_t, ChunkIndexHash> map{};
+            for (size_t i = 0; i < indices.size(); i++)
+                map.try_emplace(indices[i], i);
+            return map.size();
+        });
+
+        std::unordered_map<ChunkIndex, size_t, ChunkIndexHash> node_map{};
+        FlatHashMap<ChunkIndex, size_t, ChunkIndexHash> flat_map{};
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            node_map.try_emplace(indices[i], i);
+            flat_map.try_emplace(indices[i], i);
+        }
+
+        run("cache: lookup, std::unordered_map, " + suffix, Iterations, [&]
+        {
+            size_t sum{};
+            for (auto const& index : lookups)
+                sum += node_map.find(index)->second;
+            return sum;
+        });
+
+        run("cache: lookup, flat, " + suffix, Iterations, [&]
+        {
+            size_t sum{};
+            for (auto const& index : lookups)
+                sum += *flat_map.find(index);
+            return sum;
+        });
+
+        // Creating the chunks dominates the first pass
+        run("cache: ChunkCache create, " + suffix, 1, [&]
+        {
+            ChunkCache cache{};
+            size_t count{};
+            for (auto const& index : indices)
+                count += cache.get_chunk_at(index) != nullptr;
+            return count;
+        });
+
+        ChunkCache cache{};
+        for (auto const& index : indices)
+            cache.get_chunk_at(index);
+
+        run("cache: ChunkCache lookup, " + suffix, Iterations, [&]
+        {
+            size_t count{};
+            for (auto const& index : lookups)
+                count += cache.get_chunk_at(index)->state() == ChunkState::Created;
+            return count;
+        });
+
+        // A camera flying along x, touching the chunks around it every
+        // frame. Its chunks stay in the Created state, as if unloaded, so
+        // they can all be evicted.
+        constexpr int64_t FlythroughRadius = 6;
+        constexpr size_t FlythroughFrames = 2000;
+        ChunkCache flythrough_cache{ 4096 };
+        size_t frame{};
+        run("cache: flythrough, 4096 chunk budget", FlythroughFrames, [&]
+        {
+            auto camera_index = ChunkIndex{ static_cast<int64_t>(frame++ / 8), 0, 0 };
+            size_t count{};
+            for (int64_t z = -FlythroughRadius; z < FlythroughRadius; z++)
+            {
+                for (int64_t y = -FlythroughRadius; y < FlythroughRadius; y++)
+                {
+                    for (int64_t x = -FlythroughRadius; x < FlythroughRadius; x++)
+                        count += flythrough_cache.get_chunk_at(camera_index + ChunkIndex{ x, y, z })->state() == ChunkState::Created;
+                }
+            }
+            flythrough_cache.evict(ChunkCache::get_chunk_center(camera_index));
+            return count;
+        });
+
+        auto statistics = flythrough_cache.statistics();
+        std::printf("cache: flythrough: %zu chunks, %zu bytes, %zu evictions, %.2f%% hits\n",
+            statistics.LiveChunks, statistics.BytesHeld, statistics.Evictions, statistics.hit_rate() * 100.0);
+    }
+}
@@ -0,0 +1,93 @@
+#include "benchmark.h"
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include "chunk.h"
+#include "chunkgrid.h"
+#include "frustum.h"
+
+namespace tarragon::bench
+{
+    namespace
+    {
+        // Chunks of a cube around the origin, (2 * Radius)^3 of them
+        constexpr int64_t Radius = 12;
+
+        glm::dvec3 chunk_center(ChunkIndex const& index)
+        {
+            return glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH + Chunk::Extents::center_offset();
+        }
+    }
+
+    void grid_benchmarks()
+    {
+        constexpr size_t Iterations = 100;
+
+        std::vector<ChunkIndex> indices{};
+        ChunkGrid<ChunkIndex> grid{};
+        for (int64_t z = -Radius; z < Radius; z++)
+        {
+            for (int64_t y = -Radius; y < Radius; y++)
+            {
+                for (int64_t x = -Radius; x < Radius; x++)
+                {
+                    ChunkIndex index{ x, y, z };
+                    indices.push_back(index);
+                    grid.insert(index, index);
+                }
+            }
+        }
+        auto suffix = std::to_string(indices.size()) + " chunks";
+
+        // The camera in the middle of the chunks, as set up by the engine
+        auto projection = glm::perspectiveFovRH_ZO(glm::radians(70.0f), 1280.0f, 720.0f, 0.25f, 1000.0f);
+        auto view = glm::lookAt(glm::vec3{ 0.0f }, glm::vec3{ 0.3f, -0.2f, -1.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+        Frustum frustum{ projection * view };
+
+        run("grid: frustum, linear, " + suffix, Iterations, [&]
+        {
+            size_t count{};
+            for (auto const& index : indices)
+            {
+                glm::vec3 min{ glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH };
+                if (frustum.intersects_box(min, min + glm::vec3{ Chunk::Extents::CHUNK_WIDTH }))
+                    count++;
+            }
+            return count;
+        });
+
+        run("grid: frustum, regions, " + suffix, Iterations, [&]
+        {
+            size_t count{};
+            grid.for_each_in_frustum(frustum, [&](ChunkIndex const&, ChunkIndex const&) { count++; });
+            return count;
+        });
+
+        // The corners of the cube are beyond the unload distance
+        constexpr double UnloadDistance = Radius * Chunk::Extents::CHUNK_WIDTH;
+        glm::dvec3 position{ 0.0 };
+
+        run("grid: unload scan, linear, " + suffix, Iterations, [&]
+        {
+            size_t count{};
+            for (auto const& index : indices)
+            {
+                if (glm::distance(chunk_center(index), position) > UnloadDistance)
+                    count++;
+            }
+            return count;
+        });
+
+        run("grid: unload scan, regions, " + suffix, Iterations, [&]
+        {
+            size_t count{};
+            grid.for_each_beyond(position, UnloadDistance, [&](ChunkIndex const&, ChunkIndex const&) { count++; return true; });
+            return count;
+        });
+    }
+}
@@ -0,0 +1,12 @@
+#include "benchmark.h"
+
+int main()
+{
+    tarragon::bench::noise_benchmarks();
+    tarragon::bench::queue_benchmarks();
+    tarragon::bench::mesh_benchmarks();
+    tarragon::bench::grid_benchmarks();
+    tarragon::bench::cache_benchmarks();
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "benchmark.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chunk.h"
+#include "chunkmesher.h"
+#include "world.h"
+
+namespace tarragon::bench
+{
+    namespace
+    {
+        // Generates the chunks of a cube around the origin
+        std::vector<std::unique_ptr<Chunk>> generate_chunks()
+        {
+            constexpr int64_t Radius = 3;
+
+            World world{};
+            std::vector<std::unique_ptr<Chunk>> pchunks{};
+            for (int64_t z = -Radius; z < Radius; z++)
+            {
+                for (int64_t y = -Radius; y < Radius; y++)
+                {
+                    for (int64_t x = -Radius; x < Radius; x++)
+                    {
+                        ChunkIndex index{ x, y, z };
+                        auto pchunk = std::make_unique<Chunk>(glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH, index);
+                        world.generate_data(pchunk.get());
+                        pchunks.push_back(std::move(pchunk));
+                    }
+                }
+            }
+            return pchunks;
+        }
+    }
+
+    void mesh_benchmarks()
+    {
+        constexpr size_t Iterations = 5;
+
+        auto pchunks = generate_chunks();
+        auto suffix = std::to_string(pchunks.size()) + " chunks";
+
+        // Compared to a plain array of blocks
+        size_t block_bytes{}, uniform_count{};
+        for (auto const& pchunk : pchunks)
+        {
+            block_bytes += pchunk->data_heap_size();
+            uniform_count += pchunk->data().is_uniform() ? 1 : 0;
+        }
+        std::printf("blocks: %s: %zu bytes, %zu uniform, %zu bytes uncompressed\n", suffix.c_str(), block_bytes, uniform_count,
+            pchunks.size() * (Chunk::DataArray::size() + Chunk::BorderArray::size()) * sizeof(Block));
+
+        for (auto [name, mode] : { std::pair{ "naive", MeshingMode::Naive }, std::pair{ "greedy", MeshingMode::Greedy } })
+        {
+            size_t vertex_count{}, quad_count{};
+            for (auto const& pchunk : pchunks)
+            {
+                auto mesh = generate_mesh(*pchunk, mode);
+                vertex_count += mesh.Vertices.size();
+                quad_count += mesh.quad_count();
+            }
+            std::printf("mesh: %s, %s: %zu vertices, %zu quads\n", name, suffix.c_str(), vertex_count, quad_count);
+
+            run(std::string{ "mesh: " } + name + ", " + suffix, Iterations, [&]
+            {
+                size_t count{};
+                for (auto const& pchunk : pchunks)
+                    count += generate_mesh(*pchunk, mode).Vertices.size();
+                return count;
+            });
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include "benchmark.h"
+
+#include <vector>
+
+#include <noise/expressions.h>
+#include <noise/modules.h>
+
+using namespace tarragon::noise;
+
+namespace tarragon::bench
+{
+    namespace
+    {
+        // The production graph of World, composed from modules
+        FloatModule world_modules()
+        {
+            FloatModule xdisp = Billow<float>(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 0);
+            FloatModule ydisp = Billow<float>(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 1);
+            FloatModule zdisp = Billow<float>(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 2);
+            return Displace(RidgedMulti<float>(1 / 72.0, 2.3, 14, NoiseQuality::Best, 0),
+                xdisp, ydisp, zdisp);
+        }
+
+        // The production graph of World, composed as an expression
+        auto world_expression()
+        {
+            return expr::displace(
+                expr::ridged_multi<float>(1 / 72.0, 2.3, 14, NoiseQuality::Best, 0),
+                expr::billow<float>(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 0),
+                expr::billow<float>(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 1),
+                expr::billow<float>(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 2));
+        }
+
+        // One chunk worth of positions
+        constexpr Grid ChunkGrid{ { 100.0, -20.0, 50.0 }, { 1.0, 1.0, 1.0 }, { 16, 16, 16 } };
+
+        template <typename F>
+        float evaluate_scalar(F const& f)
+        {
+            float sum{};
+            for (size_t z = 0; z < ChunkGrid.Dims.z; z++)
+                for (size_t y = 0; y < ChunkGrid.Dims.y; y++)
+                    for (size_t x = 0; x < ChunkGrid.Dims.x; x++)
+                        sum += f(glm::vec3{ ChunkGrid.Origin + glm::dvec3{ x, y, z } * ChunkGrid.Step });
+            return sum;
+        }
+    }
+
+    void noise_benchmarks()
+    {
+        constexpr size_t Iterations = 20;
+
+        auto modules = world_modules();
+        auto expression = world_expression();
+        auto erased_expression = expression.type_erase();
+        std::vector<float> values(ChunkGrid.count());
+
+        run("noise: world chunk, modules, scalar", Iterations, [&] { return evaluate_scalar(modules); });
+        run("noise: world chunk, expression, scalar", Iterations, [&] { return evaluate_scalar(expression); });
+        run("noise: world chunk, modules, batch", Iterations, [&]
+        {
+            modules(ChunkGrid, values);
+            return values.front();
+        });
+        run("noise: world chunk, type-erased expression, batch", Iterations, [&]
+        {
+            erased_expression(ChunkGrid, values);
+            return values.front();
+        });
+    }
+}
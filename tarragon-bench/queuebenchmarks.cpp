@@ -0,0 +1,152 @@
+#include "benchmark.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boundedqueue.h>
+
+namespace tarragon::bench
+{
+    namespace
+    {
+        constexpr size_t ValuesPerProducer = 100000;
+        constexpr size_t BatchSize = 16;
+
+        // The single mutex-protected queue that ChunkTransfer used before
+        class LockedQueue
+        {
+        private:
+            std::mutex m_mtx;
+            std::queue<size_t> m_queue;
+
+        public:
+            bool try_push(size_t value)
+            {
+                std::lock_guard g{ m_mtx };
+                m_queue.push(value);
+                return true;
+            }
+
+            bool try_pop(size_t& value)
+            {
+                std::lock_guard g{ m_mtx };
+                if (m_queue.empty())
+                    return false;
+                value = m_queue.front();
+                m_queue.pop();
+                return true;
+            }
+        };
+
+        // Runs thread_count producers and thread_count consumers that pass
+        // ValuesPerProducer values each through the queue. Returns the sum of
+        // the consumed values.
+        template <typename TPush, typename TPop>
+        size_t run_contended(size_t thread_count, TPush push, TPop pop)
+        {
+            std::atomic<size_t> sum{};
+            std::atomic<size_t> remaining{ thread_count * ValuesPerProducer };
+
+            std::vector<std::jthread> threads{};
+            for (size_t t = 0; t < thread_count; t++)
+            {
+                threads.emplace_back([&push]
+                {
+                    for (size_t i = 0; i < ValuesPerProducer;)
+                        i += push(i);
+                });
+                threads.emplace_back([&]
+                {
+                    size_t local_sum{};
+                    while (remaining.load(std::memory_order_relaxed) > 0)
+                    {
+                        auto [count, value_sum] = pop();
+                        local_sum += value_sum;
+                        remaining.fetch_sub(count, std::memory_order_relaxed);
+                    }
+                    sum += local_sum;
+                });
+            }
+            threads.clear();
+
+            return sum;
+        }
+
+        std::pair<size_t, size_t> pop_one(auto& queue)
+        {
+            size_t value{};
+            if (!queue.try_pop(value))
+            {
+                std::this_thread::yield();
+                return { 0, 0 };
+            }
+            return { 1, value };
+        }
+    }
+
+    void queue_benchmarks()
+    {
+        constexpr size_t Iterations = 5;
+
+        for (size_t thread_count : { 1, 2, 4, 8 })
+        {
+            auto suffix = std::to_string(thread_count) + " producers/consumers, " + std::to_string(thread_count * ValuesPerProducer) + " values";
+
+            run("queue: mutex, " + suffix, Iterations, [&]
+            {
+                LockedQueue queue{};
+                return run_contended(thread_count,
+                    [&](size_t value) -> size_t { return queue.try_push(value); },
+                    [&] { return pop_one(queue); });
+            });
+
+            run("queue: lock-free, " + suffix, Iterations, [&]
+            {
+                BoundedQueue<size_t> queue{ 4096 };
+                return run_contended(thread_count,
+                    [&](size_t value) -> size_t
+                    {
+                        if (queue.try_push(value))
+                            return 1;
+                        std::this_thread::yield();
+                        return 0;
+                    },
+                    [&] { return pop_one(queue); });
+            });
+
+            run("queue: lock-free batch, " + suffix, Iterations, [&]
+            {
+                BoundedQueue<size_t> queue{ 4096 };
+                return run_contended(thread_count,
+                    [&](size_t value) -> size_t
+                    {
+                        std::array<size_t, BatchSize> values{};
+                        for (size_t i = 0; i < BatchSize; i++)
+                            values[i] = value + i;
+
+                        auto count = queue.try_push_batch(std::span{ values.data(), std::min(BatchSize, ValuesPerProducer - value) });
+                        if (count == 0)
+                            std::this_thread::yield();
+                        return count;
+                    },
+                    [&]
+                    {
+                        std::array<size_t, BatchSize> values{};
+                        auto count = queue.try_pop_batch(values);
+                        if (count == 0)
+                            std::this_thread::yield();
+
+                        size_t value_sum{};
+                        for (size_t i = 0; i < count; i++)
+                            value_sum += values[i];
+                        return std::pair{ count, value_sum };
+                    });
+            });
+        }
+    }
+}
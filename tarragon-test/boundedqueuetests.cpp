@@ -0,0 +1,90 @@
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <vector>
+
+#include <boundedqueue.h>
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    TEST(BoundedQueueTests, PushPop)
+    {
+        BoundedQueue<int> queue{ 3 };
+        ASSERT_THAT(queue.capacity(), Eq(4u));
+
+        for (int i = 0; i < 4; i++)
+            ASSERT_TRUE(queue.try_push(i));
+        ASSERT_FALSE(queue.try_push(4));
+
+        int value{};
+        for (int i = 0; i < 4; i++)
+        {
+            ASSERT_TRUE(queue.try_pop(value));
+            ASSERT_THAT(value, Eq(i));
+        }
+        ASSERT_FALSE(queue.try_pop(value));
+    }
+
+    TEST(BoundedQueueTests, Batch)
+    {
+        BoundedQueue<int> queue{ 8 };
+        std::array<int, 6> values{ 1, 2, 3, 4, 5, 6 };
+
+        ASSERT_THAT(queue.try_push_batch(values), Eq(6u));
+        ASSERT_THAT(queue.try_push_batch(values), Eq(2u));
+        ASSERT_THAT(queue.size_approx(), Eq(8u));
+
+        std::array<int, 5> popped{};
+        ASSERT_THAT(queue.try_pop_batch(popped), Eq(5u));
+        ASSERT_THAT(popped, ElementsAre(1, 2, 3, 4, 5));
+        ASSERT_THAT(queue.try_pop_batch(popped), Eq(3u));
+        ASSERT_THAT(popped[0], Eq(6));
+        ASSERT_THAT(popped[1], Eq(1));
+        ASSERT_THAT(popped[2], Eq(2));
+    }
+
+    TEST(BoundedQueueTests, ManyProducersAndConsumers)
+    {
+        constexpr int ThreadCount = 4;
+        constexpr int ValuesPerThread = 10000;
+        BoundedQueue<int> queue{ 64 };
+        std::vector<std::vector<int>> popped(ThreadCount);
+
+        {
+            std::vector<std::jthread> threads{};
+            for (int t = 0; t < ThreadCount; t++)
+            {
+                threads.emplace_back([&queue, t]
+                {
+                    for (int i = 0; i < ValuesPerThread; i++)
+                    {
+                        while (!queue.try_push(t * ValuesPerThread + i))
+                            std::this_thread::yield();
+                    }
+                });
+                threads.emplace_back([&queue, &popped, t]
+                {
+                    std::array<int, 8> values{};
+                    while (popped[t].size() < ValuesPerThread)
+                    {
+                        auto count = queue.try_pop_batch(std::span{ values.data(), std::min<size_t>(values.size(), ValuesPerThread - popped[t].size()) });
+                        popped[t].insert(std::end(popped[t]), std::begin(values), std::begin(values) + count);
+                    }
+                });
+            }
+        }
+
+        std::vector<int> all{};
+        for (auto const& values : popped)
+            all.insert(std::end(all), std::begin(values), std::end(values));
+        std::sort(std::begin(all), std::end(all));
+
+        ASSERT_THAT(all.size(), Eq(size_t{ ThreadCount * ValuesPerThread }));
+        for (int i = 0; i < ThreadCount * ValuesPerThread; i++)
+            ASSERT_THAT(all[i], Eq(i));
+    }
+}
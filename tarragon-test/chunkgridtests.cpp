@@ -0,0 +1,202 @@
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include "chunkgrid.h"
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        using Key = std::tuple<int64_t, int64_t, int64_t>;
+        using Entries = std::vector<std::pair<Key, int>>;
+
+        Key key_of(ChunkIndex const& index) { return Key{ index.x, index.y, index.z }; }
+        ChunkIndex index_of(Key const& key) { return ChunkIndex{ std::get<0>(key), std::get<1>(key), std::get<2>(key) }; }
+
+        // Collects the values that a query calls its function with, in order of their keys
+        template <typename Query>
+        Entries collect(Query&& query)
+        {
+            Entries entries{};
+            query([&](ChunkIndex const& index, int value) { entries.emplace_back(key_of(index), value); return true; });
+            std::sort(entries.begin(), entries.end());
+            return entries;
+        }
+
+        // The values of the reference whose chunk satisfies a predicate
+        template <typename Predicate>
+        Entries filter(std::map<Key, int> const& reference, Predicate&& predicate)
+        {
+            Entries entries{};
+            for (auto const& [key, value] : reference)
+            {
+                if (predicate(index_of(key)))
+                    entries.emplace_back(key, value);
+            }
+            return entries;
+        }
+
+        glm::vec3 chunk_min(ChunkIndex const& index) { return glm::vec3{ glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH }; }
+        glm::vec3 chunk_max(ChunkIndex const& index) { return chunk_min(index) + glm::vec3{ Chunk::Extents::CHUNK_WIDTH }; }
+        glm::dvec3 chunk_center(ChunkIndex const& index) { return glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH + Chunk::Extents::center_offset(); }
+
+        // The grid holds the same values as the reference, queries match linear scans of it
+        void expect_same(ChunkGrid<int>& grid, std::map<Key, int> const& reference, Frustum const& frustum, glm::dvec3 const& position)
+        {
+            ASSERT_THAT(grid.size(), Eq(reference.size()));
+
+            std::set<Key> regions{};
+            for (auto const& [key, value] : reference)
+            {
+                auto index = index_of(key);
+                regions.insert(key_of(ChunkIndex{ index.x >> 3, index.y >> 3, index.z >> 3 }));
+
+                auto pvalue = grid.find(index);
+                ASSERT_THAT(pvalue, NotNull());
+                ASSERT_THAT(*pvalue, Eq(value));
+            }
+            ASSERT_THAT(grid.region_count(), Eq(regions.size()));
+
+            auto all = collect([&](auto&& f) { grid.for_each(f); });
+            ASSERT_THAT(all, ContainerEq(filter(reference, [](ChunkIndex const&) { return true; })));
+
+            auto visible = collect([&](auto&& f) { grid.for_each_in_frustum(frustum, f); });
+            ASSERT_THAT(visible, ContainerEq(filter(reference, [&](ChunkIndex const& index)
+            {
+                return frustum.intersects_box(chunk_min(index), chunk_max(index));
+            })));
+
+            for (double distance : { 0.0, 40.0, 100.0, 1000.0 })
+            {
+                auto beyond = collect([&](auto&& f) { grid.for_each_beyond(position, distance, f); });
+                ASSERT_THAT(beyond, ContainerEq(filter(reference, [&](ChunkIndex const& index)
+                {
+                    return glm::distance(chunk_center(index), position) > distance;
+                })));
+            }
+        }
+    }
+
+    static_assert(ChunkGrid<int>::RegionWidth == 8);
+
+    TEST(ChunkGridTests, InsertFindErase)
+    {
+        ChunkGrid<int> grid{};
+
+        ASSERT_TRUE(grid.insert(ChunkIndex{ 1, 2, 3 }, 5));
+        ASSERT_FALSE(grid.insert(ChunkIndex{ 1, 2, 3 }, 6));
+        ASSERT_THAT(grid.find(ChunkIndex{ 1, 2, 3 }), Pointee(Eq(5)));
+        ASSERT_THAT(grid.find(ChunkIndex{ 3, 2, 1 }), IsNull());
+
+        ASSERT_TRUE(grid.erase(ChunkIndex{ 1, 2, 3 }));
+        ASSERT_FALSE(grid.erase(ChunkIndex{ 1, 2, 3 }));
+        ASSERT_THAT(grid.find(ChunkIndex{ 1, 2, 3 }), IsNull());
+        ASSERT_TRUE(grid.empty());
+    }
+
+    TEST(ChunkGridTests, EraseMovesLastValueOfRegion)
+    {
+        ChunkGrid<int> grid{};
+        // Three chunks of the region at the origin, one of the region below it
+        grid.insert(ChunkIndex{ 0, 0, 0 }, 0);
+        grid.insert(ChunkIndex{ 1, 0, 0 }, 1);
+        grid.insert(ChunkIndex{ 7, 7, 7 }, 2);
+        grid.insert(ChunkIndex{ -1, 0, 0 }, 3);
+        ASSERT_THAT(grid.region_count(), Eq(2u));
+
+        // The first value is replaced by the last one, which must still be
+        // found after another value takes the place it moved out of
+        grid.erase(ChunkIndex{ 0, 0, 0 });
+        grid.insert(ChunkIndex{ 2, 0, 0 }, 4);
+        ASSERT_THAT(grid.find(ChunkIndex{ 7, 7, 7 }), Pointee(Eq(2)));
+        ASSERT_THAT(grid.find(ChunkIndex{ 1, 0, 0 }), Pointee(Eq(1)));
+        ASSERT_THAT(grid.find(ChunkIndex{ 2, 0, 0 }), Pointee(Eq(4)));
+
+        // Erasing the last value moves nothing
+        grid.erase(ChunkIndex{ 2, 0, 0 });
+        ASSERT_THAT(grid.find(ChunkIndex{ 7, 7, 7 }), Pointee(Eq(2)));
+        ASSERT_THAT(grid.find(ChunkIndex{ 1, 0, 0 }), Pointee(Eq(1)));
+        ASSERT_THAT(grid.find(ChunkIndex{ 2, 0, 0 }), IsNull());
+
+        // Empty regions are removed
+        grid.erase(ChunkIndex{ 1, 0, 0 });
+        grid.erase(ChunkIndex{ 7, 7, 7 });
+        ASSERT_THAT(grid.region_count(), Eq(1u));
+        grid.erase(ChunkIndex{ -1, 0, 0 });
+        ASSERT_THAT(grid.region_count(), Eq(0u));
+        ASSERT_TRUE(grid.empty());
+    }
+
+    TEST(ChunkGridTests, MatchesLinearScan)
+    {
+        // Looking along +x and slightly down from a point near the middle of the chunks
+        glm::dvec3 position{ 40.0, 20.0, -30.0 };
+        auto projection = glm::perspectiveFovRH_ZO(glm::radians(70.0f), 16.0f, 9.0f, 0.1f, 300.0f);
+        auto view = glm::lookAtRH(glm::vec3{ position }, glm::vec3{ position } + glm::vec3{ 1.0f, -0.3f, 0.2f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+        Frustum frustum{ projection * view };
+
+        std::mt19937 rng{ 42 };
+        std::uniform_int_distribution<int64_t> coordinate{ -20, 19 };
+        std::bernoulli_distribution inserting{ 0.6 };
+
+        ChunkGrid<int> grid{};
+        std::map<Key, int> reference{};
+        for (int step = 0; step < 4000; step++)
+        {
+            // Erase existing chunks as often as missing ones, so regions fill up and empty again
+            ChunkIndex index{ coordinate(rng), coordinate(rng), coordinate(rng) };
+            if (inserting(rng))
+            {
+                auto inserted = reference.emplace(key_of(index), step).second;
+                ASSERT_THAT(grid.insert(index, step), Eq(inserted));
+            }
+            else
+            {
+                if (!reference.empty() && step % 2 == 0)
+                {
+                    auto it = reference.begin();
+                    std::advance(it, std::uniform_int_distribution<size_t>{ 0, reference.size() - 1 }(rng));
+                    index = index_of(it->first);
+                }
+                auto erased = reference.erase(key_of(index)) > 0;
+                ASSERT_THAT(grid.erase(index), Eq(erased));
+            }
+
+            if (step % 200 == 0)
+                ASSERT_NO_FATAL_FAILURE(expect_same(grid, reference, frustum, position));
+        }
+
+        // Empty the grid again
+        while (!reference.empty())
+        {
+            auto index = index_of(reference.begin()->first);
+            reference.erase(reference.begin());
+            ASSERT_TRUE(grid.erase(index));
+        }
+        ASSERT_NO_FATAL_FAILURE(expect_same(grid, reference, frustum, position));
+        ASSERT_THAT(grid.region_count(), Eq(0u));
+    }
+
+    TEST(ChunkGridTests, ForEachBeyondStops)
+    {
+        ChunkGrid<int> grid{};
+        for (int64_t x = 0; x < 20; x++)
+            grid.insert(ChunkIndex{ x, 0, 0 }, 0);
+
+        size_t calls{};
+        grid.for_each_beyond(glm::dvec3{ 0.0 }, 0.0, [&](ChunkIndex const&, int) { return ++calls < 5; });
+
+        ASSERT_THAT(calls, Eq(5u));
+    }
+}
@@ -0,0 +1,173 @@
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "chunkmesher.h"
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        // A unit face of a block: the face and the lowest corner of its quad
+        using UnitFace = std::tuple<uint32_t, int, int, int>;
+
+        constexpr int Width = static_cast<int>(Chunk::WIDTH);
+
+        // Fills a chunk and its border with rock, each block with the given probability
+        Chunk random_chunk(std::mt19937& rng, double solid)
+        {
+            std::bernoulli_distribution is_solid{ solid };
+            auto random_block = [&]() { return Block{ is_solid(rng) ? BlockType::Rock : BlockType::Air }; };
+
+            Chunk chunk{ glm::dvec3{ 0.0 }, ChunkIndex{ 0 } };
+            for (int z = -1; z <= Width; z++)
+            {
+                for (int y = -1; y <= Width; y++)
+                {
+                    for (int x = -1; x <= Width; x++)
+                    {
+                        glm::ivec3 position{ x, y, z };
+                        if (x >= 0 && x < Width && y >= 0 && y < Width && z >= 0 && z < Width)
+                            chunk.set_at(glm::size3{ position }, random_block());
+                        else if (Chunk::is_border(position))
+                            chunk.set_border_at(position, random_block());
+                    }
+                }
+            }
+            chunk.compact_data();
+            return chunk;
+        }
+
+        // Splits every quad of a mesh into the unit faces it covers
+        std::vector<UnitFace> unit_faces(ChunkMesh const& mesh)
+        {
+            std::vector<UnitFace> faces{};
+            for (size_t i = 0; i < mesh.Vertices.size(); i += ChunkMesh::VerticesPerQuad)
+            {
+                auto lower = glm::ivec3{ mesh.Vertices.at(i).position() };
+                auto upper = lower;
+                for (size_t j = 1; j < ChunkMesh::VerticesPerQuad; j++)
+                {
+                    auto corner = glm::ivec3{ mesh.Vertices.at(i + j).position() };
+                    lower = glm::min(lower, corner);
+                    upper = glm::max(upper, corner);
+                }
+
+                // The quad is flat along the axis of its normal
+                auto face = mesh.Vertices.at(i).face();
+                auto axis = static_cast<int>(face / 2);
+                upper[axis]++;
+                for (int z = lower.z; z < upper.z; z++)
+                    for (int y = lower.y; y < upper.y; y++)
+                        for (int x = lower.x; x < upper.x; x++)
+                            faces.emplace_back(face, x, y, z);
+            }
+            std::sort(faces.begin(), faces.end());
+            return faces;
+        }
+    }
+
+    TEST(ChunkMesherTests, GreedyCoversNaiveFaces)
+    {
+        std::mt19937 rng{ 42 };
+        for (double solid : { 0.1, 0.5, 0.9 })
+        {
+            auto chunk = random_chunk(rng, solid);
+            auto naive = unit_faces(generate_mesh(chunk, MeshingMode::Naive));
+            auto greedy = unit_faces(generate_mesh(chunk, MeshingMode::Greedy));
+
+            ASSERT_THAT(naive, Not(IsEmpty()));
+            // Greedy quads don't overlap, and together cover the same faces
+            ASSERT_THAT(std::adjacent_find(greedy.begin(), greedy.end()), Eq(greedy.end()));
+            ASSERT_THAT(greedy, ContainerEq(naive));
+        }
+    }
+
+    TEST(ChunkMesherTests, GreedyMergesFaces)
+    {
+        Chunk chunk{ glm::dvec3{ 0.0 }, ChunkIndex{ 0 } };
+        for (size_t z = 0; z < 3; z++)
+            for (size_t x = 0; x < 5; x++)
+                chunk.set_at(glm::size3{ x, 0, z }, Block{ BlockType::Rock });
+
+        auto mesh = generate_mesh(chunk, MeshingMode::Greedy);
+
+        ASSERT_THAT(mesh.quad_count(), Eq(6u));
+    }
+
+    TEST(ChunkMesherTests, TexCoordsRepeatPerBlock)
+    {
+        std::mt19937 rng{ 7 };
+        auto chunk = random_chunk(rng, 0.7);
+
+        for (auto mode : { MeshingMode::Naive, MeshingMode::Greedy })
+        {
+            auto mesh = generate_mesh(chunk, mode);
+            ASSERT_THAT(mesh.Vertices, Not(IsEmpty()));
+
+            // The texture runs from the first corner to the second in x and
+            // to the third in y, scaled to the extent of the quad
+            for (size_t i = 0; i < mesh.Vertices.size(); i += ChunkMesh::VerticesPerQuad)
+            {
+                auto const& v0 = mesh.Vertices.at(i);
+                auto const& v1 = mesh.Vertices.at(i + 1);
+                auto const& v2 = mesh.Vertices.at(i + 2);
+                auto const& v3 = mesh.Vertices.at(i + 3);
+
+                auto u_extent = glm::length(v1.position() - v0.position());
+                auto v_extent = glm::length(v2.position() - v0.position());
+                ASSERT_THAT(v0.texcoord(), Eq(glm::vec2{ 0.0f }));
+                ASSERT_THAT(v1.texcoord(), Eq(glm::vec2{ u_extent, 0.0f }));
+                ASSERT_THAT(v2.texcoord(), Eq(glm::vec2{ 0.0f, v_extent }));
+                ASSERT_THAT(v3.texcoord(), Eq(glm::vec2{ u_extent, v_extent }));
+                if (mode == MeshingMode::Naive)
+                    ASSERT_THAT(u_extent * v_extent, Eq(1.0f));
+            }
+        }
+    }
+
+    TEST(ChunkMesherTests, BorderBlocksCullFaces)
+    {
+        constexpr std::array<glm::ivec3, 6> normals
+        {
+            glm::ivec3{ 1, 0, 0 },
+            glm::ivec3{ -1, 0, 0 },
+            glm::ivec3{ 0, 1, 0 },
+            glm::ivec3{ 0, -1, 0 },
+            glm::ivec3{ 0, 0, 1 },
+            glm::ivec3{ 0, 0, -1 },
+        };
+
+        for (uint32_t face = 0; face < normals.size(); face++)
+        {
+            // A single block on the edge of the chunk, with a border block in front of the face
+            glm::ivec3 position{ 5, 6, 7 };
+            auto axis = static_cast<int>(face / 2);
+            position[axis] = normals.at(face)[axis] > 0 ? Width - 1 : 0;
+            auto border = position + normals.at(face);
+
+            for (auto type : { BlockType::Rock, BlockType::Air })
+            {
+                Chunk chunk{ glm::dvec3{ 0.0 }, ChunkIndex{ 0 } };
+                chunk.set_at(glm::size3{ position }, Block{ BlockType::Rock });
+                chunk.set_border_at(border, Block{ type });
+
+                for (auto mode : { MeshingMode::Naive, MeshingMode::Greedy })
+                {
+                    auto mesh = generate_mesh(chunk, mode);
+                    auto faces = unit_faces(mesh);
+                    auto culled = std::none_of(faces.begin(), faces.end(), [face](UnitFace const& other) { return std::get<0>(other) == face; });
+
+                    ASSERT_THAT(mesh.quad_count(), Eq(type == BlockType::Rock ? 5u : 6u));
+                    ASSERT_THAT(culled, Eq(type == BlockType::Rock));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include "gmock/gmock.h"
+
+#include <vector>
+
+#include "chunk.h"
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        constexpr int Width = static_cast<int>(Chunk::WIDTH);
+
+        // Every position just outside one of the six faces of a chunk
+        std::vector<glm::ivec3> border_positions()
+        {
+            std::vector<glm::ivec3> positions{};
+            for (int axis = 0; axis < 3; axis++)
+            {
+                for (int side : { -1, Width })
+                {
+                    for (int v = 0; v < Width; v++)
+                    {
+                        for (int u = 0; u < Width; u++)
+                        {
+                            glm::ivec3 position{};
+                            position[axis] = side;
+                            position[(axis + 1) % 3] = u;
+                            position[(axis + 2) % 3] = v;
+                            positions.push_back(position);
+                        }
+                    }
+                }
+            }
+            return positions;
+        }
+    }
+
+    TEST(ChunkTests, IsBorder)
+    {
+        ASSERT_TRUE(Chunk::is_border(glm::ivec3{ -1, 0, 0 }));
+        ASSERT_TRUE(Chunk::is_border(glm::ivec3{ 3, Width, 5 }));
+        ASSERT_FALSE(Chunk::is_border(glm::ivec3{ 0, 0, 0 }));
+        ASSERT_FALSE(Chunk::is_border(glm::ivec3{ -1, -1, 0 }));
+        ASSERT_FALSE(Chunk::is_border(glm::ivec3{ Width, 0, Width }));
+        ASSERT_FALSE(Chunk::is_border(glm::ivec3{ -2, 0, 0 }));
+    }
+
+    TEST(ChunkTests, BorderIndicesCoverBorder)
+    {
+        auto positions = border_positions();
+        ASSERT_THAT(positions.size(), Eq(Chunk::BorderArray::size()));
+
+        // Every border position of all six sides has its own index
+        std::vector<bool> used(positions.size());
+        for (auto const& position : positions)
+        {
+            ASSERT_TRUE(Chunk::is_border(position));
+
+            auto index = Chunk::border_index_for(position);
+            ASSERT_THAT(index, Lt(used.size()));
+            ASSERT_FALSE(used.at(index));
+            used.at(index) = true;
+        }
+    }
+
+    TEST(ChunkTests, SetBorderAt)
+    {
+        Chunk chunk{ glm::dvec3{ 0.0 }, ChunkIndex{ 0 } };
+        auto positions = border_positions();
+
+        for (auto const& position : positions)
+        {
+            chunk.set_border_at(position, Block{ BlockType::Rock });
+            ASSERT_THAT(chunk.border_at(position), Eq(Block{ BlockType::Rock }));
+
+            size_t solid{};
+            for (auto const& other : positions)
+                solid += chunk.border_at(other).Type == BlockType::Rock ? 1 : 0;
+            ASSERT_THAT(solid, Eq(1u));
+
+            chunk.set_border_at(position, Block{ BlockType::Air });
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#include "gmock/gmock.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include "camera.h"
+#include "chunkcache.h"
+#include "chunktransfer.h"
+#include "clock.h"
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        // Dequeues every chunk queued for loading, returns whichever of the two came first
+        Chunk* first_loaded(ChunkTransfer& transfer, Chunk* pfirst, Chunk* psecond)
+        {
+            Chunk* pfound = nullptr;
+            Chunk* pchunk = nullptr;
+            while (transfer.dequeue_to_load(&pchunk))
+            {
+                if (pfound == nullptr && (pchunk == pfirst || pchunk == psecond))
+                    pfound = pchunk;
+            }
+            return pfound;
+        }
+    }
+
+    TEST(ChunkTransferTests, CameraReordersLoadQueue)
+    {
+        Camera camera{};
+        camera.set_resolution(16, 9);
+        camera.set_planes(0.1f, 1000.0f);
+        camera.set_fov(70.0f);
+
+        ChunkCache cache{};
+        ChunkTransfer transfer{ &camera, &cache };
+        Clock clock{};
+
+        // The camera looks down -z: the chunk in front is farther away than
+        // the one behind, but loads first as it is in view
+        auto pfront = cache.get_chunk_at(ChunkIndex{ 0, 0, -10 });
+        auto pbehind = cache.get_chunk_at(ChunkIndex{ 0, 0, 6 });
+
+        transfer.enqueue_to_load(pfront);
+        transfer.enqueue_to_load(pbehind);
+        transfer.update(clock);
+        ASSERT_THAT(first_loaded(transfer, pfront, pbehind), Eq(pfront));
+
+        // Turning around brings the other chunk into view
+        transfer.enqueue_to_load(pfront);
+        transfer.enqueue_to_load(pbehind);
+        camera.set_rotation(glm::rotate(glm::identity<glm::quat>(), glm::pi<float>(), Camera::UP));
+        transfer.update(clock);
+        ASSERT_THAT(first_loaded(transfer, pfront, pbehind), Eq(pbehind));
+
+        // Moving back past the first chunk, both are in view and the nearer one loads first
+        transfer.enqueue_to_load(pfront);
+        transfer.enqueue_to_load(pbehind);
+        camera.set_position(glm::vec3{ 8.0f, 8.0f, -400.0f });
+        transfer.update(clock);
+        ASSERT_THAT(first_loaded(transfer, pfront, pbehind), Eq(pfront));
+    }
+
+    TEST(ChunkTransferTests, ReadyChunksCountTowardsCacheBytes)
+    {
+        Camera camera{};
+        ChunkCache cache{};
+        ChunkTransfer transfer{ &camera, &cache };
+
+        auto pchunk = cache.get_chunk_at(ChunkIndex{ 1, 2, 3 });
+        pchunk->set_at(glm::size3{ 4, 5, 6 }, Block{ BlockType::Rock });
+        ASSERT_THAT(pchunk->data_heap_size(), Gt(0u));
+        auto before = cache.statistics();
+        ASSERT_THAT(before.LiveChunks, Eq(1u));
+
+        // Counted from the main thread dequeueing the chunk for rendering
+        Chunk* pready = nullptr;
+        transfer.enqueue_to_render(pchunk);
+        ASSERT_THAT(cache.statistics().BytesHeld, Eq(before.BytesHeld));
+        ASSERT_TRUE(transfer.dequeue_to_render(&pready));
+        ASSERT_THAT(cache.statistics().BytesHeld, Eq(before.BytesHeld + pchunk->data_heap_size()));
+
+        // Until it is dequeued for unloading, before its blocks are cleared
+        Chunk* punloading = nullptr;
+        ASSERT_TRUE(transfer.enqueue_to_unload(pchunk));
+        ASSERT_TRUE(transfer.dequeue_to_unload(&punloading));
+        punloading->clear_data();
+        ASSERT_THAT(cache.statistics().BytesHeld, Eq(before.BytesHeld));
+        ASSERT_THAT(cache.statistics().LiveChunks, Eq(1u));
+    }
+}
@@ -0,0 +1,111 @@
+#include "gmock/gmock.h"
+
+#include <vector>
+
+#include <noise/expressions.h>
+#include <noise/graph.h>
+
+using namespace testing;
+using namespace tarragon::noise;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        // Checks that two graphs consist of the same nodes
+        template <typename T>
+        void expect_same_graph(graph::NodePtr<T> const& pnode, graph::NodePtr<T> const& pexpected)
+        {
+            ASSERT_THAT(pnode, NotNull());
+            ASSERT_THAT(pnode->Type, Eq(pexpected->Type));
+            ASSERT_THAT(pnode->Parameters, Eq(pexpected->Parameters));
+            ASSERT_THAT(pnode->Sources.size(), Eq(pexpected->Sources.size()));
+            for (size_t i = 0; i < pnode->Sources.size(); i++)
+                expect_same_graph(pnode->Sources[i], pexpected->Sources[i]);
+        }
+
+        // Checks that an expression and a module produce the same values,
+        // both for single positions and for a batch
+        template <typename T, typename E>
+        void expect_same_values(E const& expression, BasicModule<T> const& module)
+        {
+            Grid grid{ { -8.3, 2.1, 13.7 }, { 0.7, 0.9, 1.1 }, { 8, 8, 8 } };
+            std::vector<T> expected(grid.count());
+            module(grid, expected);
+
+            auto erased = expression.type_erase();
+            expect_same_graph(erased.node(), module.node());
+            std::vector<T> values(grid.count());
+            erased(grid, values);
+
+            size_t i{};
+            for (size_t z = 0; z < grid.Dims.z; z++)
+            {
+                for (size_t y = 0; y < grid.Dims.y; y++)
+                {
+                    for (size_t x = 0; x < grid.Dims.x; x++)
+                    {
+                        typename BasicModule<T>::Position pos{ grid.Origin + glm::dvec3{ x, y, z } * grid.Step };
+                        ASSERT_THAT(expression(pos), Eq(module(pos)));
+                        ASSERT_THAT(values.at(i), Eq(expected.at(i)));
+                        i++;
+                    }
+                }
+            }
+        }
+    }
+
+    TEST(NoiseExpressionTests, Constant)
+    {
+        auto constant = expr::constant(2.5);
+
+        ASSERT_THAT(constant({ 0.0, 0.0, 0.0 }), Eq(2.5));
+        ASSERT_THAT(constant.type_erase()({ 1.0, 10.0, 100.0 }), Eq(2.5));
+    }
+
+    TEST(NoiseExpressionTests, MatchesModules)
+    {
+        expect_same_values(
+            expr::add(expr::scale_bias(expr::perlin(0.1), 2.0, 0.5), expr::clamp(expr::billow(0.2, 3.0, 4), -0.5, 0.5)),
+            Add(ScaleBias(Perlin(0.1), 2.0, 0.5), Clamp(Billow(0.2, 3.0, 4), -0.5, 0.5)));
+        expect_same_values(
+            expr::blend(expr::abs(expr::ridged_multi(0.05)), expr::invert(expr::perlin()), expr::max(expr::perlin(), expr::constant(0.3))),
+            Blend(Abs(RidgedMulti(0.05)), Invert(Perlin()), Max(Perlin(), Constant(0.3))));
+        expect_same_values(
+            expr::multiply(expr::scale_point(expr::perlin(), { 0.5, 0.25, 2.0 }), expr::translate_point(expr::from_module(Cell()), { 3.0, 2.0, 1.0 })),
+            Multiply(ScalePoint(Perlin(), { 0.5, 0.25, 2.0 }), TranslatePoint(Cell(), { 3.0, 2.0, 1.0 })));
+    }
+
+    TEST(NoiseExpressionTests, MatchesModulesFloat)
+    {
+        expect_same_values(
+            expr::displace(
+                expr::ridged_multi<float>(1 / 72.0, 2.3, 14, NoiseQuality::Best, 0),
+                expr::billow<float>(0.1, 3, 8, 0.5, NoiseQuality::Standard, 0),
+                expr::billow<float>(0.1, 3, 8, 0.5, NoiseQuality::Standard, 1),
+                expr::min(expr::perlin<float>(), expr::constant<float>(0.2))),
+            Displace(
+                RidgedMulti<float>(1 / 72.0, 2.3, 14, NoiseQuality::Best, 0),
+                Billow<float>(0.1, 3, 8, 0.5, NoiseQuality::Standard, 0),
+                Billow<float>(0.1, 3, 8, 0.5, NoiseQuality::Standard, 1),
+                Min(Perlin<float>(), Constant<float>(0.2))));
+    }
+
+    TEST(NoiseExpressionTests, BatchesOfDifferentSizes)
+    {
+        // Nested expressions reuse the same scratch buffers for each batch
+        auto expression = expr::displace(
+            expr::add(expr::perlin(), expr::translate_point(expr::billow(), { 1.0, 2.0, 3.0 })),
+            expr::perlin(0.5), expr::billow(0.5), expr::ridged_multi(0.5));
+
+        for (size_t count : { 512u, 7u, 1u, 300u })
+        {
+            Grid grid{ { 3.1, -4.2, 5.3 }, { 0.3, 0.5, 0.7 }, { count, 1, 1 } };
+            std::vector<double> values(grid.count());
+            expression.type_erase()(grid, values);
+
+            for (size_t i = 0; i < count; i++)
+                ASSERT_THAT(values.at(i), Eq(expression(grid.Origin + glm::dvec3{ static_cast<double>(i), 0.0, 0.0 } * grid.Step)));
+        }
+    }
+}
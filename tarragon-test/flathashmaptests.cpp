@@ -0,0 +1,113 @@
+#include "gmock/gmock.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <flathashmap.h>
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        struct MixingHash
+        {
+            size_t operator()(int64_t key) const noexcept
+            {
+                auto hash = static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ull;
+                return static_cast<size_t>(hash ^ (hash >> 31));
+            }
+        };
+
+        // Puts all keys into the same group with the same control byte
+        struct CollidingHash
+        {
+            size_t operator()(int64_t) const noexcept { return 0; }
+        };
+    }
+
+    TEST(FlatHashMapTests, TryEmplaceFind)
+    {
+        FlatHashMap<int64_t, std::string, MixingHash> map{};
+        auto [pa, inserted_a] = map.try_emplace(1, "a");
+        auto [pb, inserted_b] = map.try_emplace(2, "b");
+        auto [pa2, inserted_a2] = map.try_emplace(1, "c");
+
+        ASSERT_TRUE(inserted_a);
+        ASSERT_TRUE(inserted_b);
+        ASSERT_FALSE(inserted_a2);
+        ASSERT_THAT(map.size(), Eq(2u));
+        ASSERT_THAT(map.find(1), Pointee(Eq("a")));
+        ASSERT_THAT(map.find(2), Pointee(Eq("b")));
+        ASSERT_THAT(map.find(3), IsNull());
+    }
+
+    TEST(FlatHashMapTests, Grows)
+    {
+        FlatHashMap<int64_t, int64_t, MixingHash> map{};
+        for (int64_t i = 0; i < 10000; i++)
+            map.try_emplace(i * 7, i);
+
+        ASSERT_THAT(map.size(), Eq(10000u));
+        ASSERT_THAT(map.capacity(), Ge(10000u));
+        for (int64_t i = 0; i < 10000; i++)
+        {
+            ASSERT_THAT(map.find(i * 7), Pointee(i));
+            ASSERT_FALSE(map.contains(i * 7 + 1));
+        }
+    }
+
+    TEST(FlatHashMapTests, EraseKeepsCollidingKeys)
+    {
+        FlatHashMap<int64_t, int64_t, CollidingHash> map{};
+        for (int64_t i = 0; i < 40; i++)
+            map.try_emplace(i, i);
+
+        for (int64_t i = 0; i < 40; i += 2)
+            ASSERT_TRUE(map.erase(i));
+        ASSERT_FALSE(map.erase(0));
+
+        ASSERT_THAT(map.size(), Eq(20u));
+        for (int64_t i = 0; i < 40; i++)
+        {
+            if (i % 2 == 0)
+                ASSERT_THAT(map.find(i), IsNull());
+            else
+                ASSERT_THAT(map.find(i), Pointee(i));
+        }
+    }
+
+    TEST(FlatHashMapTests, ReusesDeletedSlots)
+    {
+        FlatHashMap<int64_t, int64_t, MixingHash> map{};
+        map.reserve(100);
+        auto capacity = map.capacity();
+
+        for (int64_t i = 0; i < 100000; i++)
+        {
+            map.try_emplace(i, i);
+            map.erase(i - 50);
+        }
+
+        ASSERT_THAT(map.size(), Eq(50u));
+        ASSERT_THAT(map.capacity(), Eq(capacity));
+    }
+
+    TEST(FlatHashMapTests, ForEachClear)
+    {
+        FlatHashMap<int64_t, int64_t, MixingHash> map{};
+        for (int64_t i = 0; i < 100; i++)
+            map.try_emplace(i, i * 2);
+
+        std::map<int64_t, int64_t> values{};
+        map.for_each([&](int64_t key, int64_t value) { values.emplace(key, value); });
+        ASSERT_THAT(values.size(), Eq(100u));
+        ASSERT_THAT(values.at(42), Eq(84));
+
+        map.clear();
+        ASSERT_TRUE(map.empty());
+        ASSERT_THAT(map.find(42), IsNull());
+    }
+}
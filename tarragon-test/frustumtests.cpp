@@ -0,0 +1,69 @@
+#include "gmock/gmock.h"
+
+#include <utility>
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include "frustum.h"
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        // Looking down -z from the origin, 90 degrees wide and high, with a
+        // clip space depth range of 0 to 1 like the camera's projection
+        Frustum make_frustum()
+        {
+            auto projection = glm::perspectiveFovRH_ZO(glm::radians(90.0f), 1.0f, 1.0f, 1.0f, 100.0f);
+            auto view = glm::lookAtRH(glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 0.0f, -1.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+            return Frustum{ projection * view };
+        }
+    }
+
+    TEST(FrustumTests, BoxInside)
+    {
+        auto frustum = make_frustum();
+
+        ASSERT_TRUE(frustum.contains_box(glm::vec3{ -1.0f, -1.0f, -11.0f }, glm::vec3{ 1.0f, 1.0f, -9.0f }));
+        ASSERT_TRUE(frustum.intersects_box(glm::vec3{ -1.0f, -1.0f, -11.0f }, glm::vec3{ 1.0f, 1.0f, -9.0f }));
+        // Just beyond the near plane and just before the far plane
+        ASSERT_TRUE(frustum.contains_box(glm::vec3{ -0.1f, -0.1f, -1.5f }, glm::vec3{ 0.1f, 0.1f, -1.1f }));
+        ASSERT_TRUE(frustum.contains_box(glm::vec3{ -1.0f, -1.0f, -99.0f }, glm::vec3{ 1.0f, 1.0f, -98.0f }));
+        ASSERT_TRUE(frustum.intersects_sphere(glm::vec3{ 0.0f, 0.0f, -10.0f }, 1.0f));
+    }
+
+    TEST(FrustumTests, BoxOutside)
+    {
+        auto frustum = make_frustum();
+
+        // Behind the camera, between the camera and the near plane, beyond the far plane
+        ASSERT_FALSE(frustum.intersects_box(glm::vec3{ -1.0f, -1.0f, 5.0f }, glm::vec3{ 1.0f, 1.0f, 7.0f }));
+        ASSERT_FALSE(frustum.intersects_box(glm::vec3{ -0.1f, -0.1f, -0.9f }, glm::vec3{ 0.1f, 0.1f, -0.5f }));
+        ASSERT_FALSE(frustum.intersects_box(glm::vec3{ -1.0f, -1.0f, -150.0f }, glm::vec3{ 1.0f, 1.0f, -120.0f }));
+        // Beside and above the view
+        ASSERT_FALSE(frustum.intersects_box(glm::vec3{ 50.0f, -1.0f, -11.0f }, glm::vec3{ 60.0f, 1.0f, -9.0f }));
+        ASSERT_FALSE(frustum.intersects_box(glm::vec3{ -1.0f, 20.0f, -11.0f }, glm::vec3{ 1.0f, 30.0f, -9.0f }));
+        ASSERT_FALSE(frustum.contains_box(glm::vec3{ -1.0f, -1.0f, 5.0f }, glm::vec3{ 1.0f, 1.0f, 7.0f }));
+        ASSERT_FALSE(frustum.intersects_sphere(glm::vec3{ 0.0f, 0.0f, 10.0f }, 1.0f));
+    }
+
+    TEST(FrustumTests, BoxStraddling)
+    {
+        auto frustum = make_frustum();
+
+        // Across the near plane, the far plane and a side plane
+        for (auto [min, max] : {
+            std::pair{ glm::vec3{ -0.1f, -0.1f, -2.0f }, glm::vec3{ 0.1f, 0.1f, 0.0f } },
+            std::pair{ glm::vec3{ -1.0f, -1.0f, -110.0f }, glm::vec3{ 1.0f, 1.0f, -90.0f } },
+            std::pair{ glm::vec3{ 5.0f, -1.0f, -11.0f }, glm::vec3{ 15.0f, 1.0f, -9.0f } },
+        })
+        {
+            ASSERT_TRUE(frustum.intersects_box(min, max));
+            ASSERT_FALSE(frustum.contains_box(min, max));
+        }
+        ASSERT_TRUE(frustum.intersects_sphere(glm::vec3{ 0.0f, 0.0f, -0.5f }, 1.0f));
+    }
+}
@@ -1,7 +1,149 @@
 #include "gmock/gmock.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include <noise/generator.h>
 
 using namespace testing;
 using namespace tarragon::noise;
 
+namespace tarragon::tests
+{
+    namespace
+    {
+        std::vector<glm::dvec3> test_positions()
+        {
+            std::vector<glm::dvec3> positions
+            {
+                { 0.0, 0.0, 0.0 },
+                { 1.0, 2.0, 3.0 },
+                { -1.0, -2.0, -3.0 },
+                { -0.5, 0.5, -0.25 },
+                { 1.0e6 + 0.3, -1.0e6 - 0.7, 12345.678 },
+            };
+            for (int i = 0; i < 61; i++)
+                positions.push_back(glm::dvec3{ i * 0.37 - 11.0, i * -1.13 + 4.0, i * 2.71 - 80.0 });
+            return positions;
+        }
+
+        // Positions on a spiral with the given radius, exactly representable in float
+        std::vector<glm::vec3> float_test_positions(double radius)
+        {
+            std::vector<glm::vec3> positions{};
+            for (int i = 0; i < 1000; i++)
+                positions.push_back(glm::vec3{ glm::dvec3{ std::sin(i * 0.731), std::cos(i * 1.37), std::sin(i * 2.11 + 1.0) } * radius });
+            return positions;
+        }
+
+        double max_float_error(std::vector<glm::vec3> const& positions)
+        {
+            double max_error{};
+            for (auto const& pos : positions)
+            {
+                auto error = std::abs(gradient_coherent_noise_3d(glm::dvec3{ pos }) - gradient_coherent_noise_3d(pos));
+                max_error = std::max(max_error, error);
+            }
+            return max_error;
+        }
+    }
+
+    TEST(NoiseGeneratorTests, GradientCoherentNoiseBatchMatchesScalar)
+    {
+        auto positions = test_positions();
+        std::vector<double> values(positions.size());
+
+        for (auto quality : { NoiseQuality::Fast, NoiseQuality::Standard, NoiseQuality::Best })
+        {
+            for (int32_t seed : { 0, 1, 12345, -7 })
+            {
+                gradient_coherent_noise_3d(positions, values, seed, quality);
+                for (size_t i = 0; i < positions.size(); i++)
+                    ASSERT_THAT(values.at(i), Eq(gradient_coherent_noise_3d(positions.at(i), seed, quality)));
+            }
+        }
+    }
+
+    TEST(NoiseGeneratorTests, GradientCoherentNoiseRange)
+    {
+        auto positions = test_positions();
+        std::vector<double> values(positions.size());
+        gradient_coherent_noise_3d(positions, values);
+
+        for (auto value : values)
+            ASSERT_THAT(value, AllOf(Ge(-1.0), Le(1.0)));
+    }
+
+    TEST(NoiseGeneratorTests, GradientCoherentNoiseRangeOverBox)
+    {
+        std::vector<Box<double>> boxes
+        {
+            { { 0.1, 0.2, 0.3 }, { 0.4, 0.5, 0.6 } },
+            { { -1.7, 2.5, -0.25 }, { -0.9, 3.25, 0.75 } },
+            { { 3.0, -2.0, 5.0 }, { 3.0, -2.0, 5.0 } },
+            { { -10.3, 7.1, 1.0e4 }, { -3.2, 7.6, 1.0e4 + 0.5 } },
+        };
+
+        for (auto quality : { NoiseQuality::Fast, NoiseQuality::Standard, NoiseQuality::Best })
+        {
+            for (auto const& box : boxes)
+            {
+                auto [lower, upper] = gradient_coherent_noise_3d_range(box, 3, quality);
+                ASSERT_THAT(lower, Le(upper));
+
+                for (int z = 0; z <= 10; z++)
+                {
+                    for (int y = 0; y <= 10; y++)
+                    {
+                        for (int x = 0; x <= 10; x++)
+                        {
+                            auto pos = box.Lower + (box.Upper - box.Lower) * glm::dvec3{ x, y, z } / 10.0;
+                            ASSERT_THAT(gradient_coherent_noise_3d(pos, 3, quality), AllOf(Ge(lower), Le(upper)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    TEST(NoiseGeneratorTests, GradientCoherentNoiseRangeNarrowsForSmallBoxes)
+    {
+        glm::dvec3 pos{ 4.3, -1.6, 0.7 };
+        auto value = gradient_coherent_noise_3d(pos);
+
+        auto [lower, upper] = gradient_coherent_noise_3d_range(Box<double>{ pos - 0.01, pos + 0.01 });
+        ASSERT_THAT(lower, Le(value));
+        ASSERT_THAT(upper, Ge(value));
+        ASSERT_THAT(upper - lower, Lt(0.5));
+
+        auto [global_lower, global_upper] = gradient_coherent_noise_3d_range(Box<double>{ glm::dvec3{ -100.0 }, glm::dvec3{ 100.0 } });
+        ASSERT_THAT(global_lower, Eq(-GradientCoherentNoiseBound));
+        ASSERT_THAT(global_upper, Eq(GradientCoherentNoiseBound));
+    }
+
+    TEST(NoiseGeneratorTests, GradientCoherentNoiseFloatBatchMatchesScalar)
+    {
+        auto positions = float_test_positions(50.0);
+        std::vector<float> values(positions.size());
+
+        for (auto quality : { NoiseQuality::Fast, NoiseQuality::Standard, NoiseQuality::Best })
+        {
+            for (int32_t seed : { 0, 1, 12345, -7 })
+            {
+                gradient_coherent_noise_3d(positions, values, seed, quality);
+                for (size_t i = 0; i < positions.size(); i++)
+                    ASSERT_THAT(values.at(i), Eq(gradient_coherent_noise_3d(positions.at(i), seed, quality)));
+            }
+        }
+    }
+
+    TEST(NoiseGeneratorTests, GradientCoherentNoiseFloatAccuracy)
+    {
+        // Float results drift from double ones as the integer part of the
+        // position eats into the mantissa.
+        ASSERT_THAT(max_float_error(float_test_positions(1.0)), Le(1.0e-6));
+        ASSERT_THAT(max_float_error(float_test_positions(100.0)), Le(1.0e-4));
+        ASSERT_THAT(max_float_error(float_test_positions(1.0e5)), Le(5.0e-2));
+    }
+}
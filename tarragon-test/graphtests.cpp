@@ -0,0 +1,147 @@
+#include "gmock/gmock.h"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <noise/graph.h>
+
+using namespace testing;
+using namespace tarragon::noise;
+
+namespace tarragon::tests
+{
+    namespace
+    {
+        size_t node_count(graph::NodePtr<double> const& pnode)
+        {
+            size_t count = 1;
+            for (auto const& psource : pnode->Sources)
+                count += node_count(psource);
+            return count;
+        }
+
+        std::vector<double> evaluate(Module const& module)
+        {
+            Grid grid{ { -8.3, 2.1, 13.7 }, { 0.7, 0.9, 1.1 }, { 8, 8, 8 } };
+            std::vector<double> values(grid.count());
+            module(grid, values);
+            return values;
+        }
+    }
+
+    TEST(NoiseGraphTests, FoldsConstants)
+    {
+        auto module = Add(TranslatePoint(Constant(1.5), { 1.0, 2.0, 3.0 }), ScaleBias(Constant(2.0), 3.0, -1.0));
+
+        auto pfolded = graph::fold_constants(graph::from_module(module));
+
+        ASSERT_THAT(pfolded->Type, Eq(graph::NodeType::Constant));
+        ASSERT_THAT(pfolded->Parameters, ElementsAre(6.5));
+    }
+
+    TEST(NoiseGraphTests, MergesAffineTransforms)
+    {
+        auto module = ScaleBias(ScaleBias(
+            TranslatePoint(ScalePoint(TranslatePoint(Perlin(), { 0.5, 0.0, 0.0 }), { 2.0, 2.0, 2.0 }), { 1.0, 2.0, 3.0 }),
+            2.0, 1.0), 0.5, 0.0);
+
+        auto pmerged = graph::merge_affine(graph::from_module(module));
+
+        ASSERT_THAT(node_count(pmerged), Eq(3u));
+        ASSERT_THAT(pmerged->Type, Eq(graph::NodeType::ScaleBias));
+        ASSERT_THAT(pmerged->Parameters, ElementsAre(1.0, 0.5));
+        ASSERT_THAT(pmerged->Sources.at(0)->Type, Eq(graph::NodeType::AffinePoint));
+
+        auto expected = evaluate(module);
+        auto values = evaluate(graph::compile(pmerged));
+        for (size_t i = 0; i < values.size(); i++)
+            ASSERT_THAT(values.at(i), DoubleNear(expected.at(i), 1e-12));
+    }
+
+    TEST(NoiseGraphTests, RemovesIdentityTransforms)
+    {
+        auto perlin = Perlin();
+        auto module = ScaleBias(TranslatePoint(ScalePoint(perlin), { 0.0, 0.0, 0.0 }));
+
+        ASSERT_THAT(graph::merge_affine(graph::from_module(module)), Eq(perlin.node()));
+    }
+
+    TEST(NoiseGraphTests, EliminatesDeadSelectBranches)
+    {
+        auto perlin = Perlin();
+        auto billow = Billow();
+
+        auto always_first = Select(perlin, billow, Clamp(Perlin(), 2.0, 3.0), -1.0, 1.0, 0.5);
+        auto always_second = Select(perlin, billow, Clamp(Perlin(), -0.2, 0.2), -1.0, 1.0, 0.5);
+        auto either = Select(perlin, billow, Clamp(Perlin(), 0.0, 3.0), -1.0, 1.0);
+
+        ASSERT_THAT(graph::eliminate_dead_branches(graph::from_module(always_first)), Eq(perlin.node()));
+        ASSERT_THAT(graph::eliminate_dead_branches(graph::from_module(always_second)), Eq(billow.node()));
+        ASSERT_THAT(graph::eliminate_dead_branches(graph::from_module(either)), Eq(either.node()));
+    }
+
+    TEST(NoiseGraphTests, ValueRangeOverBoxContainsValues)
+    {
+        auto module = Displace(
+            Select(RidgedMulti(0.05), Billow(0.2, 3.0, 4), Perlin(0.1), -0.25, 0.5),
+            ScaleBias(Perlin(0.1, 2.0, 3), 0.5, 0.0),
+            Clamp(Billow(0.3), -0.5, 0.5),
+            Rotate(TranslatePoint(Perlin(0.05, 2.0, 2), { 0.5, 1.0, 1.5 }), 30.0, 0.0, 45.0));
+
+        Grid grid{ { -8.3, 2.1, 13.7 }, { 0.7, 0.9, 1.1 }, { 8, 8, 8 } };
+        Box<double> box{ grid.Origin, grid.Origin + grid.Step * 7.0 };
+        auto [lower, upper] = graph::value_range(module.node(), box);
+
+        for (auto value : evaluate(module))
+            ASSERT_THAT(value, AllOf(Ge(lower), Le(upper)));
+    }
+
+    TEST(NoiseGraphTests, ValueRangeNarrowsForSmallBoxes)
+    {
+        auto module = ScaleBias(Perlin(0.01, 2.0, 2), 2.0, 1.0);
+
+        auto [lower, upper] = graph::value_range(module.node(), Box<double>{ { 10.0, 20.0, 30.0 }, { 11.0, 21.0, 31.0 } });
+        auto [global_lower, global_upper] = graph::value_range(module.node());
+
+        ASSERT_THAT(upper - lower, Lt(1.0));
+        ASSERT_THAT(global_upper - global_lower, Gt(4.0));
+    }
+
+    TEST(NoiseGraphTests, EvaluatesCommonSubgraphsOnce)
+    {
+        auto pcalls = std::make_shared<std::atomic<size_t>>(0);
+        Module counting
+        {
+            [pcalls](Module::Position pos) { (*pcalls)++; return pos.x; },
+            [pcalls](std::span<Module::Position const> positions, std::span<double> values)
+            {
+                (*pcalls)++;
+                for (size_t i = 0; i < positions.size(); i++)
+                    values[i] = positions[i].x;
+            }
+        };
+        auto module = Add(ScaleBias(counting, 2.0, 1.0), ScaleBias(counting, 2.0, 1.0));
+
+        auto optimized = graph::optimize(module);
+        auto values = evaluate(optimized);
+
+        ASSERT_THAT(pcalls->load(), Eq(1u));
+        ASSERT_THAT(values, Eq(evaluate(module)));
+    }
+
+    TEST(NoiseGraphTests, OptimizedMatchesOriginal)
+    {
+        auto module = Displace(
+            Select(RidgedMulti(0.05), Billow(0.2, 3.0, 4), Perlin(0.1), -0.25, 0.5, 0.125),
+            Perlin(0.1, 2.0, 6, 0.5, NoiseQuality::Standard, 1),
+            Max(Turbulence(Cylinders(), 0.3), Constant(0.3)),
+            Terrace(Curve(Perlin(), std::array{ ControlPoint{ -1.0, -1.0 }, ControlPoint{ 0.0, 0.5 }, ControlPoint{ 0.5, 0.0 }, ControlPoint{ 1.0, 1.0 } }.data(), 4),
+                std::array{ -1.0, 0.0, 1.0 }.data(), 3, true));
+
+        auto optimized = graph::optimize(module);
+
+        ASSERT_THAT(evaluate(optimized), Eq(evaluate(module)));
+        ASSERT_THAT(optimized({ 3.7, -1.2, 9.9 }), Eq(module({ 3.7, -1.2, 9.9 })));
+    }
+}
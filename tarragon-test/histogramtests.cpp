@@ -0,0 +1,37 @@
+#include "gmock/gmock.h"
+
+#include <chrono>
+
+#include <histogram.h>
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace tarragon::tests
+{
+    TEST(LatencyHistogramTests, Empty)
+    {
+        LatencyHistogram histogram{};
+
+        ASSERT_THAT(histogram.count(), Eq(0u));
+        ASSERT_THAT(histogram.quantile(0.5), Eq(0ns));
+    }
+
+    TEST(LatencyHistogramTests, Quantiles)
+    {
+        LatencyHistogram histogram{};
+        for (int i = 0; i < 98; i++)
+            histogram.record(3us);
+        histogram.record(5ms);
+        histogram.record(-1ns);
+
+        ASSERT_THAT(histogram.count(), Eq(100u));
+        ASSERT_THAT(histogram.bucket_count(0), Eq(1u));
+        ASSERT_THAT(histogram.quantile(0.0), Eq(2ns));
+        ASSERT_THAT(histogram.quantile(0.5), AllOf(Gt(3us), Le(6us)));
+        ASSERT_THAT(histogram.quantile(1.0), AllOf(Gt(5ms), Le(10ms)));
+
+        histogram.reset();
+        ASSERT_THAT(histogram.count(), Eq(0u));
+    }
+}
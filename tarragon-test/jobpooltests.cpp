@@ -0,0 +1,54 @@
+#include "gmock/gmock.h"
+
+#include <atomic>
+#include <latch>
+
+#include <jobpool.h>
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    TEST(JobPoolTests, RunsAllJobs)
+    {
+        constexpr size_t JobCount = 1000;
+        std::atomic<size_t> run_count{};
+        std::latch done{ JobCount };
+
+        JobPool pool{ 4 };
+        for (size_t i = 0; i < JobCount; i++)
+        {
+            pool.submit([&]
+            {
+                run_count++;
+                done.count_down();
+            });
+        }
+        done.wait();
+
+        ASSERT_THAT(run_count.load(), Eq(JobCount));
+    }
+
+    TEST(JobPoolTests, RunsJobsSubmittedByJobs)
+    {
+        constexpr size_t JobCount = 100;
+        std::atomic<size_t> run_count{};
+        std::latch done{ JobCount };
+
+        JobPool pool{ 3 };
+        for (size_t i = 0; i < JobCount; i++)
+        {
+            pool.submit([&]
+            {
+                pool.submit([&]
+                {
+                    run_count++;
+                    done.count_down();
+                });
+            });
+        }
+        done.wait();
+
+        ASSERT_THAT(run_count.load(), Eq(JobCount));
+    }
+}
@@ -1,5 +1,7 @@
 #include "gmock/gmock.h"
 
+#include <vector>
+
 #include <noise/modules.h>
 
 using namespace testing;
@@ -49,4 +51,121 @@ namespace tarragon::tests
         auto blend3 = Blend(Constant(1), Constant(2), Constant(0.5));
         ASSERT_THAT(blend3({}), Eq(1.5));
     }
+
+    TEST(NoiseModuleTests, Cache)
+    {
+        size_t calls0{}, calls1{};
+        auto cache0 = Cache(Module{ [&calls0](glm::dvec3 pos) { calls0++; return pos.x; } });
+        auto cache1 = Cache(Module{ [&calls1](glm::dvec3 pos) { calls1++; return pos.y; } });
+        Grid grid{ { 1.0, 2.0, 3.0 }, { 0.5, 1.0, 2.0 }, { 4, 3, 2 } };
+        std::vector<double> values0(grid.count()), values1(grid.count());
+
+        for (int i = 0; i < 3; i++)
+        {
+            cache0(grid, values0);
+            cache1(grid, values1);
+            ASSERT_THAT(cache0({ 0.0, 0.0, 0.0 }), Eq(0.0));
+            ASSERT_THAT(cache1({ 0.0, 0.0, 0.0 }), Eq(0.0));
+        }
+
+        ASSERT_THAT(calls0, Eq(grid.count() + 1));
+        ASSERT_THAT(calls1, Eq(grid.count() + 1));
+        ASSERT_THAT(values0.at(1), Eq(1.5));
+        ASSERT_THAT(values1.at(4), Eq(3.0));
+    }
+
+    TEST(NoiseModuleTests, GridLayout)
+    {
+        auto x_module = Module{ [](glm::dvec3 pos) { return pos.x; } };
+        auto z_module = Module{ [](glm::dvec3 pos) { return pos.z; } };
+        Grid grid{ { 1.0, 2.0, 3.0 }, { 0.5, 1.0, 2.0 }, { 4, 3, 2 } };
+
+        std::vector<double> xs(grid.count()), zs(grid.count());
+        x_module(grid, xs);
+        z_module(grid, zs);
+
+        ASSERT_THAT(xs.at(0), Eq(1.0));
+        ASSERT_THAT(xs.at(3), Eq(2.5));
+        ASSERT_THAT(xs.at(4), Eq(1.0));
+        ASSERT_THAT(zs.at(11), Eq(3.0));
+        ASSERT_THAT(zs.at(12), Eq(5.0));
+    }
+
+    TEST(NoiseModuleTests, BatchMatchesScalar)
+    {
+        ControlPoint curve_points[]{ { -1.0, -1.0 }, { -0.2, 0.1 }, { 0.3, 0.2 }, { 1.0, 1.0 } };
+        double terrace_points[]{ -0.5, 0.0, 0.5 };
+
+        auto ridged = RidgedMulti(0.05, 2.3, 8, NoiseQuality::Best, 3);
+        auto displaced = Displace(ridged, Billow(0.1, 3.0, 4), Perlin(0.1), Cache(Perlin(0.2, 2.0, 3)));
+        std::vector<Module> modules
+        {
+            ridged,
+            displaced,
+            Select(Curve(displaced, curve_points, 4), Terrace(Perlin(), terrace_points, 3), Billow(), -0.2, 0.4, 0.1),
+            Select(Spheres(), Checkerboard(), Cylinders(), -0.5, 0.5),
+            Turbulence(ScaleBias(Clamp(Perlin(), -0.5, 0.5), 2.0, 0.5), 0.5, 0.25),
+            Blend(Cell(), Exponent(Invert(Abs(Perlin()))), Max(White(), Min(Perlin(), Constant(0.3)))),
+            Rotate(ScalePoint(TranslatePoint(Power(Abs(Perlin()), Constant(2.0)), { 3.0, 2.0, 1.0 }), { 0.5, 0.5, 0.5 }), 10.0, 20.0, 30.0),
+        };
+
+        Grid grid{ { -8.3, 2.1, 13.7 }, { 0.7, 0.9, 1.1 }, { 8, 8, 8 } };
+        std::vector<double> values(grid.count());
+        for (auto const& module : modules)
+        {
+            module(grid, values);
+
+            size_t i{};
+            for (size_t z = 0; z < grid.Dims.z; z++)
+                for (size_t y = 0; y < grid.Dims.y; y++)
+                    for (size_t x = 0; x < grid.Dims.x; x++)
+                        ASSERT_THAT(values.at(i++), Eq(module(grid.Origin + glm::dvec3{ x, y, z } * grid.Step)));
+        }
+    }
+
+    TEST(NoiseModuleTests, FloatBatchMatchesScalar)
+    {
+        double terrace_points[]{ -0.5, 0.0, 0.5 };
+
+        std::vector<FloatModule> modules
+        {
+            RidgedMulti<float>(0.05, 2.3, 8, NoiseQuality::Best, 3),
+            Select(Terrace(Perlin<float>(), terrace_points, 3), Billow<float>(), Cell<float>(), -0.2, 0.4, 0.1),
+            Turbulence(ScaleBias(Perlin<float>(), 2.0, 0.5), 0.5, 0.25),
+            Rotate(TranslatePoint(Spheres<float>(), { 3.0, 2.0, 1.0 }), 10.0, 20.0, 30.0),
+        };
+
+        Grid grid{ { -8.3, 2.1, 13.7 }, { 0.7, 0.9, 1.1 }, { 8, 8, 8 } };
+        std::vector<float> values(grid.count());
+        for (auto const& module : modules)
+        {
+            module(grid, values);
+
+            size_t i{};
+            for (size_t z = 0; z < grid.Dims.z; z++)
+                for (size_t y = 0; y < grid.Dims.y; y++)
+                    for (size_t x = 0; x < grid.Dims.x; x++)
+                        ASSERT_THAT(values.at(i++), Eq(module(glm::vec3{ grid.Origin + glm::dvec3{ x, y, z } * grid.Step })));
+        }
+    }
+
+    TEST(NoiseModuleTests, FloatMatchesDouble)
+    {
+        auto perlin = Perlin(0.05);
+        auto perlin_float = Perlin<float>(0.05);
+
+        // Near the origin, both precisions agree closely; far away only coarsely.
+        for (double origin : { 0.0, 1.0e5 })
+        {
+            Grid grid{ glm::dvec3{ origin }, { 0.5, 0.5, 0.5 }, { 16, 16, 16 } };
+            std::vector<double> values(grid.count());
+            std::vector<float> float_values(grid.count());
+            perlin(grid, values);
+            perlin_float(grid, float_values);
+
+            auto tolerance = origin == 0.0 ? 1.0e-5 : 1.0e-2;
+            for (size_t i = 0; i < values.size(); i++)
+                ASSERT_THAT(static_cast<double>(float_values.at(i)), DoubleNear(values.at(i), tolerance));
+        }
+    }
 }
@@ -0,0 +1,56 @@
+#include "gmock/gmock.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <objectpool.h>
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    TEST(ObjectPoolTests, CreateKeepsAddresses)
+    {
+        ObjectPool<std::string, 4> pool{};
+        std::vector<std::string*> pvalues{};
+        for (int i = 0; i < 10; i++)
+            pvalues.push_back(pool.create(std::to_string(i)));
+
+        ASSERT_THAT(pool.size(), Eq(10u));
+        ASSERT_THAT(pool.capacity(), Eq(12u));
+        for (int i = 0; i < 10; i++)
+            ASSERT_THAT(*pvalues.at(i), Eq(std::to_string(i)));
+    }
+
+    TEST(ObjectPoolTests, DestroyReusesSlots)
+    {
+        ObjectPool<int, 4> pool{};
+        auto pa = pool.create(1);
+        auto pb = pool.create(2);
+        pool.destroy(pa);
+        auto pc = pool.create(3);
+
+        ASSERT_THAT(pc, Eq(pa));
+        ASSERT_THAT(*pb, Eq(2));
+        ASSERT_THAT(*pc, Eq(3));
+        ASSERT_THAT(pool.size(), Eq(2u));
+        ASSERT_THAT(pool.capacity(), Eq(4u));
+    }
+
+    TEST(ObjectPoolTests, DestroysLiveObjects)
+    {
+        auto pcount = std::make_shared<int>();
+        {
+            ObjectPool<std::shared_ptr<int>, 4> pool{};
+            std::vector<std::shared_ptr<int>*> pvalues{};
+            for (int i = 0; i < 6; i++)
+                pvalues.push_back(pool.create(pcount));
+            pool.destroy(pvalues.at(1));
+            pool.destroy(pvalues.at(4));
+
+            ASSERT_THAT(pcount.use_count(), Eq(5));
+        }
+        ASSERT_THAT(pcount.use_count(), Eq(1));
+    }
+}
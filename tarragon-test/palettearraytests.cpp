@@ -0,0 +1,88 @@
+#include "gmock/gmock.h"
+
+#include <palettearray.h>
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    TEST(PaletteArrayTests, UniformDoesNotAllocate)
+    {
+        PaletteArray<int, 4096> array{ 7 };
+        array.set_at(12, 7);
+
+        ASSERT_TRUE(array.is_uniform());
+        ASSERT_THAT(array.at(0), Eq(7));
+        ASSERT_THAT(array.at(4095), Eq(7));
+        ASSERT_THAT(array.heap_size(), Eq(0u));
+    }
+
+    TEST(PaletteArrayTests, SetAt)
+    {
+        PaletteArray<int, 100> array{};
+        array.set_at(3, 1);
+        array.set_at(99, 2);
+
+        ASSERT_FALSE(array.is_uniform());
+        ASSERT_THAT(array.bits(), Eq(2u));
+        ASSERT_THAT(array.at(0), Eq(0));
+        ASSERT_THAT(array.at(3), Eq(1));
+        ASSERT_THAT(array.at(99), Eq(2));
+    }
+
+    TEST(PaletteArrayTests, WidensIndices)
+    {
+        PaletteArray<int, 300> array{};
+        for (int i = 0; i < 300; i++)
+            array.set_at(i, i);
+
+        ASSERT_THAT(array.bits(), Eq(16u));
+        ASSERT_THAT(array.palette_size(), Eq(300u));
+        for (int i = 0; i < 300; i++)
+            ASSERT_THAT(array.at(i), Eq(i));
+    }
+
+    TEST(PaletteArrayTests, CompactDropsUnusedValues)
+    {
+        PaletteArray<int, 64> array{};
+        for (int i = 0; i < 64; i++)
+            array.set_at(i, i % 4);
+        for (int i = 0; i < 64; i++)
+        {
+            if (i % 4 == 3)
+                array.set_at(i, 1);
+        }
+
+        array.compact();
+
+        ASSERT_THAT(array.palette_size(), Eq(3u));
+        ASSERT_THAT(array.bits(), Eq(2u));
+        for (int i = 0; i < 64; i++)
+            ASSERT_THAT(array.at(i), Eq(i % 4 == 3 ? 1 : i % 4));
+    }
+
+    TEST(PaletteArrayTests, CompactToUniform)
+    {
+        PaletteArray<int, 64> array{};
+        for (int i = 0; i < 64; i++)
+            array.set_at(i, 5);
+
+        ASSERT_FALSE(array.is_uniform());
+        array.compact();
+
+        ASSERT_TRUE(array.is_uniform());
+        ASSERT_THAT(array.at(17), Eq(5));
+        ASSERT_THAT(array.heap_size(), Eq(0u));
+    }
+
+    TEST(PaletteArrayTests, Fill)
+    {
+        PaletteArray<int, 64> array{};
+        array.set_at(1, 1);
+        array.fill(2);
+
+        ASSERT_TRUE(array.is_uniform());
+        ASSERT_THAT(array.at(1), Eq(2));
+        ASSERT_THAT(array.heap_size(), Eq(0u));
+    }
+}
@@ -0,0 +1,115 @@
+#include "gmock/gmock.h"
+
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <rangeallocator.h>
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    TEST(RangeAllocatorTests, AllocateUntilFull)
+    {
+        RangeAllocator allocator{ 10 };
+
+        ASSERT_THAT(allocator.allocate(4), Optional(0u));
+        ASSERT_THAT(allocator.allocate(4), Optional(4u));
+        ASSERT_THAT(allocator.allocate(4), Eq(std::nullopt));
+        ASSERT_THAT(allocator.allocate(2), Optional(8u));
+        ASSERT_THAT(allocator.allocate(1), Eq(std::nullopt));
+        ASSERT_THAT(allocator.allocated(), Eq(10u));
+        ASSERT_THAT(allocator.free_range_count(), Eq(0u));
+        ASSERT_THAT(allocator.allocate(0), Eq(std::nullopt));
+    }
+
+    TEST(RangeAllocatorTests, FreeMergesNeighbours)
+    {
+        RangeAllocator allocator{ 12 };
+        auto a = allocator.allocate(4);
+        auto b = allocator.allocate(4);
+        auto c = allocator.allocate(4);
+
+        allocator.free(*a, 4);
+        allocator.free(*c, 4);
+        ASSERT_THAT(allocator.free_range_count(), Eq(2u));
+        ASSERT_THAT(allocator.largest_free_range(), Eq(4u));
+
+        allocator.free(*b, 4);
+        ASSERT_THAT(allocator.free_range_count(), Eq(1u));
+        ASSERT_THAT(allocator.largest_free_range(), Eq(12u));
+        ASSERT_THAT(allocator.allocated(), Eq(0u));
+    }
+
+    TEST(RangeAllocatorTests, AllocatesBestFit)
+    {
+        RangeAllocator allocator{ 20 };
+        auto a = allocator.allocate(6);
+        allocator.allocate(2);
+        auto c = allocator.allocate(3);
+        allocator.allocate(2);
+        allocator.free(*a, 6);
+        allocator.free(*c, 3);
+
+        // The hole of 3 fits better than the hole of 6 or the rest at the end
+        ASSERT_THAT(allocator.allocate(3), Optional(*c));
+        ASSERT_THAT(allocator.allocate(5), Optional(*a));
+    }
+
+    TEST(RangeAllocatorTests, GrowMergesWithFreeEnd)
+    {
+        RangeAllocator allocator{ 8 };
+        ASSERT_THAT(allocator.allocate(6), Optional(0u));
+        ASSERT_THAT(allocator.allocate(4), Eq(std::nullopt));
+
+        allocator.grow(16);
+        ASSERT_THAT(allocator.capacity(), Eq(16u));
+        ASSERT_THAT(allocator.free_range_count(), Eq(1u));
+        ASSERT_THAT(allocator.allocate(10), Optional(6u));
+        ASSERT_THAT(allocator.allocated(), Eq(16u));
+    }
+
+    TEST(RangeAllocatorTests, RandomAllocationsDontOverlap)
+    {
+        constexpr size_t Capacity = 1000;
+        RangeAllocator allocator{ Capacity };
+        std::vector<std::pair<size_t, size_t>> ranges{};
+        std::vector<int> owners(Capacity, -1);
+        std::mt19937 rng{ 42 };
+
+        for (int i = 0; i < 10000; i++)
+        {
+            if (!ranges.empty() && rng() % 2 == 0)
+            {
+                auto index = rng() % ranges.size();
+                auto [offset, size] = ranges[index];
+                for (size_t j = offset; j < offset + size; j++)
+                    owners[j] = -1;
+                allocator.free(offset, size);
+                ranges[index] = ranges.back();
+                ranges.pop_back();
+            }
+            else
+            {
+                auto size = 1 + rng() % 50;
+                auto offset = allocator.allocate(size);
+                if (!offset)
+                    continue;
+
+                for (size_t j = *offset; j < *offset + size; j++)
+                {
+                    ASSERT_THAT(owners[j], Eq(-1));
+                    owners[j] = i;
+                }
+                ranges.push_back({ *offset, size });
+            }
+        }
+
+        for (auto [offset, size] : ranges)
+            allocator.free(offset, size);
+        ASSERT_THAT(allocator.free_range_count(), Eq(1u));
+        ASSERT_THAT(allocator.largest_free_range(), Eq(Capacity));
+    }
+}
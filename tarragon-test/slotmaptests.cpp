@@ -0,0 +1,88 @@
+#include "gmock/gmock.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <slotmap.h>
+
+using namespace testing;
+
+namespace tarragon::tests
+{
+    TEST(SlotMapTests, InsertGet)
+    {
+        SlotMap<std::string> map{};
+        auto a = map.insert("a");
+        auto b = map.insert("b");
+
+        ASSERT_THAT(map.size(), Eq(2u));
+        ASSERT_THAT(map.get(a), Pointee(Eq("a")));
+        ASSERT_THAT(map.get(b), Pointee(Eq("b")));
+        ASSERT_THAT(map.values(), ElementsAre("a", "b"));
+    }
+
+    TEST(SlotMapTests, EraseMovesLastValue)
+    {
+        SlotMap<int> map{};
+        auto a = map.insert(1);
+        auto b = map.insert(2);
+        auto c = map.insert(3);
+
+        ASSERT_TRUE(map.erase(a));
+        ASSERT_THAT(map.values(), ElementsAre(3, 2));
+        ASSERT_THAT(map.get(a), IsNull());
+        ASSERT_THAT(map.get(b), Pointee(2));
+        ASSERT_THAT(map.get(c), Pointee(3));
+
+        ASSERT_FALSE(map.erase(a));
+        ASSERT_THAT(map.size(), Eq(2u));
+    }
+
+    TEST(SlotMapTests, ReusedSlotsInvalidateOldHandles)
+    {
+        SlotMap<int> map{};
+        auto a = map.insert(1);
+        map.erase(a);
+        auto b = map.insert(2);
+
+        ASSERT_THAT(b.Index, Eq(a.Index));
+        ASSERT_FALSE(map.contains(a));
+        ASSERT_THAT(map.get(a), IsNull());
+        ASSERT_THAT(map.get(b), Pointee(2));
+    }
+
+    TEST(SlotMapTests, Clear)
+    {
+        SlotMap<std::unique_ptr<int>> map{};
+        auto a = map.insert(std::make_unique<int>(1));
+        map.clear();
+
+        ASSERT_TRUE(map.empty());
+        ASSERT_FALSE(map.contains(a));
+
+        auto b = map.insert(std::make_unique<int>(2));
+        ASSERT_THAT(map.get(b), Pointee(Pointee(2)));
+    }
+
+    TEST(SlotMapTests, ManyInsertsAndErases)
+    {
+        SlotMap<int> map{};
+        std::vector<SlotMap<int>::Handle> handles{};
+        for (int i = 0; i < 1000; i++)
+            handles.push_back(map.insert(i));
+
+        // Erase every other value
+        for (int i = 0; i < 1000; i += 2)
+            ASSERT_TRUE(map.erase(handles[i]));
+
+        ASSERT_THAT(map.size(), Eq(500u));
+        for (int i = 0; i < 1000; i++)
+        {
+            if (i % 2 == 0)
+                ASSERT_THAT(map.get(handles[i]), IsNull());
+            else
+                ASSERT_THAT(map.get(handles[i]), Pointee(i));
+        }
+    }
+}
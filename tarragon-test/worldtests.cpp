@@ -0,0 +1,86 @@
+#include "gmock/gmock.h"
+
+#include <memory>
+#include <vector>
+
+#include <noise/graph.h>
+
+#include "world.h"
+
+using namespace testing;
+using namespace tarragon::noise;
+
+namespace tarragon::tests
+{
+    TEST(WorldTests, TerrainValuesLieInValueRange)
+    {
+        auto terrain = World::terrain();
+        ASSERT_THAT(terrain.node(), NotNull());
+
+        // The padded chunks that World::generate_data samples, around the
+        // origin and further out
+        constexpr size_t padded_width = Chunk::WIDTH + 2;
+        for (auto index : { ChunkIndex{ 0, 0, 0 }, ChunkIndex{ -3, 1, 2 }, ChunkIndex{ 5, -4, 0 }, ChunkIndex{ 40, 7, -25 } })
+        {
+            Grid grid
+            {
+                glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH - glm::dvec3{ Chunk::Extents::BLOCK_SIZE },
+                glm::dvec3{ Chunk::Extents::BLOCK_SIZE },
+                glm::size3{ padded_width },
+            };
+            std::vector<float> values(grid.count());
+            terrain(grid, values);
+
+            auto range = graph::value_range(terrain.node(), Box<float>
+            {
+                glm::vec3{ grid.Origin },
+                glm::vec3{ grid.Origin + grid.Step * glm::dvec3{ padded_width - 1 } },
+            });
+            for (auto value : values)
+                ASSERT_THAT(value, AllOf(Ge(range.Lower), Le(range.Upper)));
+        }
+    }
+
+    TEST(WorldTests, BordersMatchNeighbours)
+    {
+        World world{};
+        constexpr int width = static_cast<int>(Chunk::WIDTH);
+        auto generate = [&](ChunkIndex const& index)
+        {
+            auto pchunk = std::make_unique<Chunk>(glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH, index);
+            world.generate_data(pchunk.get());
+            return pchunk;
+        };
+
+        // Chunks around the origin and further out
+        for (auto index : { ChunkIndex{ 0, 0, 0 }, ChunkIndex{ 2, -1, 3 }, ChunkIndex{ 40, 7, -25 } })
+        {
+            auto pchunk = generate(index);
+            for (int axis = 0; axis < 3; axis++)
+            {
+                for (int side : { -1, width })
+                {
+                    // The border on this side lies on the opposite edge of the neighbour
+                    ChunkIndex offset{};
+                    offset[axis] = side < 0 ? -1 : 1;
+                    auto pneighbour = generate(index + offset);
+
+                    for (int v = 0; v < width; v++)
+                    {
+                        for (int u = 0; u < width; u++)
+                        {
+                            glm::ivec3 position{};
+                            position[axis] = side;
+                            position[(axis + 1) % 3] = u;
+                            position[(axis + 2) % 3] = v;
+                            auto neighbour_position = position;
+                            neighbour_position[axis] = side < 0 ? width - 1 : 0;
+
+                            ASSERT_THAT(pchunk->border_at(position), Eq(pneighbour->at(glm::size3{ neighbour_position })));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
 #include <glm/ext/matrix_clip_space.hpp>
 
 #include "component.h"
+#include "frustum.h"
 #include "input.h"
 
 namespace tarragon
@@ -43,8 +44,12 @@ namespace tarragon
         glm::vec3 const& position() const { return m_position; }
         glm::vec3 forward() const { return m_rotation * Camera::FORWARD; }
 
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+
         glm::mat4 const& view() const { return m_view; }
         glm::mat4 const& projection() const { return m_projection; }
+        Frustum frustum() const { return Frustum{ m_projection * m_view }; }
 
         void set_resolution(int width, int height);
         void set_planes(float near_plane, float far_plane);
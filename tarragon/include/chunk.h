@@ -4,11 +4,15 @@
 #include <cstdint>
 #include <array>
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/gtx/std_based_type.hpp>
 
+#include <palettearray.h>
+
 #include "common.h"
 #include "noise/modules.h"
 
@@ -26,22 +30,93 @@ namespace tarragon
     {
         Created, // Created, no data yet
         Loading, // Waiting to generate and mesh
-        Ready, // Ready to render
+        Ready, // Ready to render, without a mesh if the chunk is empty
         Unloading, // Waiting to unload data and mesh
     };
 
+    // A vertex of a chunk mesh, packed into 32 bits
+    //
+    // Bits  0-14: position relative to the chunk origin, 5 bits per axis
+    // Bits 15-17: index of the face the vertex belongs to, see Normals
+    // Bits 18-27: texture coordinates, 5 bits per axis
+    //
+    // Positions and texture coordinates are whole numbers of blocks, up to
+    // 31. Decoded by shaders/chunk.vert.
+    struct ChunkVertex
+    {
+        static constexpr uint32_t MaxCoordinate = 31;
+
+        // Normals of the faces, indexed by face
+        static constexpr std::array<glm::vec3, 6> Normals
+        {
+            glm::vec3{ 1.0f, 0.0f, 0.0f },  //right
+            glm::vec3{ -1.0f, 0.0f, 0.0f }, //left
+            glm::vec3{ 0.0f, 1.0f, 0.0f },  //top
+            glm::vec3{ 0.0f, -1.0f, 0.0f }, //bottom
+            glm::vec3{ 0.0f, 0.0f, 1.0f },  //front
+            glm::vec3{ 0.0f, 0.0f, -1.0f }, //back
+        };
+
+        uint32_t Bits;
+
+        static constexpr ChunkVertex pack(glm::uvec3 const& position, uint32_t face, glm::uvec2 const& texcoord) noexcept
+        {
+            assert(position.x <= MaxCoordinate && position.y <= MaxCoordinate && position.z <= MaxCoordinate);
+            assert(face < Normals.size());
+            assert(texcoord.x <= MaxCoordinate && texcoord.y <= MaxCoordinate);
+
+            return ChunkVertex
+            {
+                position.x | (position.y << 5) | (position.z << 10)
+                | (face << 15)
+                | (texcoord.x << 18) | (texcoord.y << 23)
+            };
+        }
+
+        constexpr glm::vec3 position() const noexcept
+        {
+            return glm::vec3{ glm::uvec3{ Bits & 31u, (Bits >> 5) & 31u, (Bits >> 10) & 31u } };
+        }
+
+        constexpr uint32_t face() const noexcept { return (Bits >> 15) & 7u; }
+        constexpr glm::vec3 normal() const noexcept { return Normals[face()]; }
+
+        constexpr glm::vec2 texcoord() const noexcept
+        {
+            return glm::vec2{ glm::uvec2{ (Bits >> 18) & 31u, (Bits >> 23) & 31u } };
+        }
+    };
+    static_assert(sizeof(ChunkVertex) == 4);
+
+    // Every four vertices form a quad, corners ordered so that the quad is
+    // drawn as the triangles 0,1,2 and 1,3,2. There are no per-mesh indices,
+    // all meshes are drawn with the same shared index buffer.
     struct ChunkMesh
     {
+        static constexpr size_t VerticesPerQuad = 4;
+        static constexpr size_t IndicesPerQuad = 6;
+
+        // Vertices written to the staging ring of the renderer
+        struct StagedVertices
+        {
+            size_t Offset;
+            size_t Count;
+        };
+
         glm::vec3 WorldPosition;
-        std::vector<glm::vec3> Positions;
-        std::vector<glm::vec3> Normals;
-        std::vector<glm::vec2> TexCoords;
-        std::vector<uint32_t> Indices;
+        std::vector<ChunkVertex> Vertices;
+        // If set, the vertices were moved from Vertices to the staging ring
+        std::optional<StagedVertices> Staged;
+
+        size_t vertex_count() const noexcept { return Staged ? Staged->Count : Vertices.size(); }
+        size_t quad_count() const noexcept { return vertex_count() / VerticesPerQuad; }
     };
 
     struct Block
     {
         BlockType Type;
+
+        friend constexpr bool operator==(Block const&, Block const&) = default;
     };
 
     template <size_t Width, double BlockSize>
@@ -51,6 +126,7 @@ namespace tarragon
         static_assert(BlockSize > 0.0, "Chunk block size can't be 0 or less.");
 
     public:
+        static constexpr double BLOCK_SIZE = BlockSize;
         static constexpr double CHUNK_WIDTH = Width * BlockSize;
 
     private:
@@ -91,13 +167,33 @@ namespace tarragon
 
     using ChunkIndex = glm::i64vec3;
 
+    // Mixes all three coordinates of a chunk index into all bits of the hash
+    struct ChunkIndexHash
+    {
+        size_t operator()(ChunkIndex const& index) const noexcept
+        {
+            auto hash = static_cast<uint64_t>(index.x) * 0x9e3779b97f4a7c15ull;
+            hash = (hash ^ (hash >> 29) ^ static_cast<uint64_t>(index.y)) * 0xbf58476d1ce4e5b9ull;
+            hash = (hash ^ (hash >> 32) ^ static_cast<uint64_t>(index.z)) * 0x94d049bb133111ebull;
+            return static_cast<size_t>(hash ^ (hash >> 31));
+        }
+    };
+
     class Chunk final
     {
     public:
         static constexpr size_t WIDTH = 16;
+        static_assert(WIDTH <= ChunkVertex::MaxCoordinate, "Chunk vertices can't address every block.");
+        // Upper bound on the quads of a mesh: one per face between two
+        // neighbouring blocks, along each of the three axes
+        static constexpr size_t MAX_QUADS = 3 * (WIDTH + 1) * WIDTH * WIDTH;
 
         using Extents = ChunkExtents<WIDTH, 1.0>;
-        using DataArray = std::array<Block, WIDTH * WIDTH * WIDTH>;
+        // Blocks are palette compressed, chunks of a single block type,
+        // like the air above the terrain, allocate nothing
+        using DataArray = PaletteArray<Block, WIDTH * WIDTH * WIDTH>;
+        // The blocks of the neighbouring chunks that touch each of the six faces
+        using BorderArray = PaletteArray<Block, 6 * WIDTH * WIDTH>;
 
         static constexpr size_t index_for(glm::size3 const& position) noexcept
         {
@@ -108,12 +204,43 @@ namespace tarragon
             return (WIDTH * WIDTH * position.z) + (WIDTH * position.y) + position.x;
         }
 
+        // Whether a position lies just outside one face of the chunk, i.e.
+        // one coordinate is -1 or WIDTH and the others are inside the chunk
+        static constexpr bool is_border(glm::ivec3 const& position) noexcept
+        {
+            constexpr int width = static_cast<int>(WIDTH);
+
+            int outside{};
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (position[axis] < -1 || position[axis] > width)
+                    return false;
+                if (position[axis] == -1 || position[axis] == width)
+                    outside++;
+            }
+            return outside == 1;
+        }
+
+        static constexpr size_t border_index_for(glm::ivec3 const& position) noexcept
+        {
+            assert(is_border(position));
+
+            constexpr int width = static_cast<int>(WIDTH);
+            auto axis = (position.x < 0 || position.x == width) ? 0 : ((position.y < 0 || position.y == width) ? 1 : 2);
+            auto side = position[axis] == width ? 1 : 0;
+            auto u = position[(axis + 1) % 3];
+            auto v = position[(axis + 2) % 3];
+
+            return ((static_cast<size_t>(axis * 2 + side) * WIDTH) + v) * WIDTH + u;
+        }
+
     private:
         ChunkIndex m_chunk_index;
         Extents m_extents;
 
         ChunkState m_state;
-        std::unique_ptr<DataArray> m_pdata;
+        DataArray m_data;
+        BorderArray m_border;
         std::unique_ptr<ChunkMesh> m_pmesh;
 
     public:
@@ -121,7 +248,8 @@ namespace tarragon
             : m_extents{ world_origin }
             , m_chunk_index{ chunk_index }
             , m_state{ ChunkState::Created }
-            , m_pdata{ std::make_unique<DataArray>() }
+            , m_data{}
+            , m_border{}
             , m_pmesh{}
         { }
 
@@ -134,7 +262,8 @@ namespace tarragon
         constexpr ChunkState const& state() const noexcept { return m_state; }
         constexpr ChunkState& state() noexcept { return m_state; }
 
-        const DataArray* data() const noexcept { return m_pdata.get(); }
+        DataArray const& data() const noexcept { return m_data; }
+        BorderArray const& border() const noexcept { return m_border; }
         const ChunkMesh* mesh() const noexcept { return m_pmesh.get(); }
         
         void set_mesh(ChunkMesh&& mesh)
@@ -145,20 +274,65 @@ namespace tarragon
         void clear_data()
         {
             m_pmesh = {};
-            m_pdata = std::make_unique<DataArray>();
+            m_data.fill(Block{ BlockType::Air });
+            m_border.fill(Block{ BlockType::Air });
             state() = ChunkState::Created;
         }
 
-        constexpr Block at(glm::size3 const& pos) const
+        Block at(glm::size3 const& pos) const
         {
             auto index = Chunk::index_for(pos);
-            return m_pdata->at(index);
+            return m_data.at(index);
         }
 
         void set_at(glm::size3 const& pos, Block block)
         {
             auto index = Chunk::index_for(pos);
-            m_pdata->at(index) = block;
+            m_data.set_at(index, block);
+        }
+
+        // Gets a block of a neighbouring chunk, see is_border
+        Block border_at(glm::ivec3 const& pos) const
+        {
+            auto index = Chunk::border_index_for(pos);
+            return m_border.at(index);
         }
+
+        void set_border_at(glm::ivec3 const& pos, Block block)
+        {
+            auto index = Chunk::border_index_for(pos);
+            m_border.set_at(index, block);
+        }
+
+        // Sets all blocks of the chunk and its border to the same block,
+        // without allocating
+        void fill(Block block)
+        {
+            m_data.fill(block);
+            m_border.fill(block);
+        }
+
+        // Drops the block types that were overwritten while setting blocks,
+        // see PaletteArray::compact()
+        void compact_data()
+        {
+            m_data.compact();
+            m_border.compact();
+        }
+
+        // Whether the chunk has no faces to mesh: all of its blocks are air,
+        // or they are all solid and so are all the blocks around it. Only
+        // looks at uniform arrays, so it takes constant time.
+        bool is_empty() const noexcept
+        {
+            if (!m_data.is_uniform())
+                return false;
+            if (m_data.at(0).Type == BlockType::Air)
+                return true;
+            return m_border.is_uniform() && m_border.at(0).Type != BlockType::Air;
+        }
+
+        // Bytes allocated for the blocks, excluding the mesh
+        size_t data_heap_size() const noexcept { return m_data.heap_size() + m_border.heap_size(); }
     };
 }
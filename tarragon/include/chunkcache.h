@@ -1,19 +1,48 @@
 #pragma once
 
 #include <cstdint>
-#include <unordered_map>
-#include <memory>
 #include <vector>
 
 #include <glm/vec3.hpp>
 
+#include <flathashmap.h>
+#include <objectpool.h>
+
 #include "chunk.h"
 
 namespace tarragon
 {
+	// counters of a chunk cache, see ChunkCache::statistics()
+	struct ChunkCacheStatistics
+	{
+		size_t LiveChunks;
+		// the chunk pool and the blocks of the chunks that are ready or
+		// unloading, excluding meshes
+		size_t BytesHeld;
+		size_t Evictions;
+		// lookups that found a chunk, and lookups that created one
+		size_t Hits;
+		size_t Misses;
+
+		double hit_rate() const noexcept
+		{
+			auto lookups = Hits + Misses;
+			return lookups > 0 ? static_cast<double>(Hits) / static_cast<double>(lookups) : 1.0;
+		}
+	};
+
+	// Creates chunks when they are first looked up, and destroys the ones
+	// furthest away once more than a budget of chunks is alive
+	//
+	// Only chunks in the Created state are evicted: chunks that were never
+	// queued for loading, or that were unloaded and cleared. The others
+	// are referenced by the load queue, the workers or the renderer.
+	// Not thread safe, used on the main thread.
 	class ChunkCache
 	{
 	public:
+		static constexpr size_t DefaultMaxChunks = 16 * 1024;
+
 		// gets the index of the chunk, ie the xth/yth/zth chunk on each axis
 		static ChunkIndex get_chunk_index(glm::dvec3 const& world_position);
 
@@ -24,18 +53,43 @@ namespace tarragon
 		static glm::dvec3 get_chunk_center(ChunkIndex const& chunk_index);
 
 	private:
-		static constexpr uint64_t P0 = 1050112070355889ui64;
-		static constexpr uint64_t P1 = 2456099197ui64;
+		size_t m_max_chunks;
 
-		// calculates a primitive hash from the chunk index to improve lookup
-		static int64_t get_chunk_index_hash(ChunkIndex const& chunk_index);
+		// chunks never move, so the pointers handed out stay valid
+		ObjectPool<Chunk> m_chunk_pool{};
+		FlatHashMap<ChunkIndex, Chunk*, ChunkIndexHash> m_chunks{};
 
-		std::unordered_multimap<int64_t, std::unique_ptr<Chunk>> m_chunks{};
+		// heap bytes of the blocks counted by add_chunk_data
+		size_t m_data_bytes{};
+		size_t m_evictions{};
+		size_t m_hits{};
+		size_t m_misses{};
 
 	public:
+		explicit ChunkCache(size_t max_chunks = DefaultMaxChunks)
+			: m_max_chunks{ max_chunks }
+		{ }
+
+		ChunkCache(ChunkCache const&) = delete;
+		ChunkCache& operator= (ChunkCache const&) = delete;
+
 		Chunk* get_chunk_at(glm::dvec3 const& world_pos);
 		Chunk* get_chunk_at(ChunkIndex const& chunk_index);
 
+		// destroys the evictable chunks furthest from world_pos while more
+		// than the budget of chunks are alive. Evicts down to 7/8 of the
+		// budget, so that the chunks aren't scanned every frame.
+		void evict(glm::dvec3 const& world_pos);
+
+		// counts the blocks of a chunk towards the bytes held once its data
+		// is ready, until it is unloaded. The blocks must not change in
+		// between, and workers must be done writing them.
+		void add_chunk_data(Chunk const* pchunk);
+		void remove_chunk_data(Chunk const* pchunk);
+
+		// reads the counters, without looking at the chunks
+		ChunkCacheStatistics statistics() const;
+
 		std::vector<ChunkIndex> chunk_indices_around(glm::dvec3 const& world_pos, double max_distance);
 	};
 }
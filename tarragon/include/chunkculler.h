@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "glad/gl.h"
+#include "frustum.h"
+#include "shader.h"
+
+namespace tarragon
+{
+    // Layout of the commands read by glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand
+    {
+        GLuint Count;
+        GLuint InstanceCount;
+        GLuint FirstIndex;
+        GLint BaseVertex;
+        GLuint BaseInstance;
+    };
+
+    // Culls chunk draw commands on the GPU
+    //
+    // A compute pass tests the box of every chunk against the view frustum,
+    // and against a depth pyramid (hierarchical Z buffer) built from the
+    // depth of the previous frame, and writes the draw commands of the
+    // chunks that pass into the visible draw buffer. The number of visible
+    // draws is written to the draw count buffer, for
+    // glMultiDrawElementsIndirectCount, so the CPU never learns which chunks
+    // were culled.
+    //
+    // The depth pyramid has half the resolution of the framebuffer, and every
+    // texel holds the farthest depth of the pixels it covers. It is built
+    // from a framebuffer owned by the culler, whose depth attachment is
+    // known to be GL_DEPTH_COMPONENT32F. The format of the default
+    // framebuffer's depth is up to the platform, often 24 bit depth with
+    // stencil, and can't be copied into a float texture. The chunks are
+    // drawn into the culler's framebuffer, and its color is then copied to
+    // the default framebuffer.
+    class ChunkCuller final
+    {
+    private:
+        Shader m_cull_shader;
+        Shader m_hiz_shader;
+
+        size_t m_draw_capacity{};
+        GLuint m_visible_draw_buffer{};
+        GLuint m_draw_count_buffer{};
+
+        int m_width{};
+        int m_height{};
+        GLuint m_framebuffer{};
+        GLuint m_color_texture{};
+        GLuint m_depth_texture{};
+        GLuint m_hiz_texture{};
+        GLsizei m_hiz_levels{};
+        // View-projection that the depth pyramid was rendered with
+        glm::mat4 m_hiz_view_projection{};
+        bool m_hiz_valid{};
+
+        void resize_framebuffer(int width, int height);
+
+    public:
+        ChunkCuller() = default;
+        ~ChunkCuller();
+
+        ChunkCuller(ChunkCuller const&) = delete;
+        ChunkCuller& operator= (ChunkCuller const&) = delete;
+
+        void initialize();
+
+        // Culls draw_count commands of the draw buffer, whose base instance
+        // indexes the chunk origins of the origin buffer
+        void cull(GLuint origin_buffer, GLuint draw_buffer, size_t draw_count, Frustum const& frustum);
+
+        // Binds the culler's framebuffer for drawing, cleared and resized
+        // to width by height
+        void bind_framebuffer(int width, int height);
+
+        // Copies the color of the culler's framebuffer to the default
+        // framebuffer, and binds the default framebuffer again
+        void unbind_framebuffer();
+
+        // Builds the depth pyramid from the depth of the culler's
+        // framebuffer, to cull the next frame with
+        void build_hiz(glm::mat4 const& view_projection);
+
+        GLuint visible_draw_buffer() const noexcept { return m_visible_draw_buffer; }
+        GLuint draw_count_buffer() const noexcept { return m_draw_count_buffer; }
+    };
+}
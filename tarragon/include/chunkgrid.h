@@ -0,0 +1,193 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "chunk.h"
+#include "frustum.h"
+
+namespace tarragon
+{
+    // Values keyed by ChunkIndex, bucketed into cubic regions of chunks
+    //
+    // Spatial queries test whole regions first, and only look at the chunks
+    // of the regions that straddle the queried volume, so their cost grows
+    // with the number of regions plus the chunks near the boundary instead
+    // of with the number of chunks. Inserting, finding and erasing a value
+    // take constant time. Values in a region are stored contiguously and
+    // may move when another value of the region is erased.
+    template <typename T>
+    class ChunkGrid final
+    {
+    public:
+        // Regions are RegionWidth chunks wide on each axis
+        static constexpr int64_t RegionShift = 3;
+        static constexpr int64_t RegionWidth = int64_t{ 1 } << RegionShift;
+        static constexpr size_t RegionSize = RegionWidth * RegionWidth * RegionWidth;
+
+    private:
+        static constexpr uint16_t NoSlot = 0xffff;
+
+        struct Region
+        {
+            std::vector<std::pair<ChunkIndex, T>> Values;
+            // Position in Values of the value of each chunk of the region
+            std::array<uint16_t, RegionSize> Slots;
+
+            Region()
+            {
+                Slots.fill(NoSlot);
+            }
+        };
+
+        std::unordered_map<ChunkIndex, Region, ChunkIndexHash> m_regions;
+        size_t m_size{};
+
+        static ChunkIndex region_of(ChunkIndex const& index) noexcept
+        {
+            return ChunkIndex{ index.x >> RegionShift, index.y >> RegionShift, index.z >> RegionShift };
+        }
+
+        static size_t slot_of(ChunkIndex const& index) noexcept
+        {
+            constexpr int64_t mask = RegionWidth - 1;
+            return static_cast<size_t>(((index.z & mask) * RegionWidth + (index.y & mask)) * RegionWidth + (index.x & mask));
+        }
+
+        static glm::dvec3 region_min(ChunkIndex const& region) noexcept
+        {
+            return glm::dvec3{ region } * (RegionWidth * Chunk::Extents::CHUNK_WIDTH);
+        }
+
+        static glm::dvec3 region_max(ChunkIndex const& region) noexcept
+        {
+            return region_min(region) + glm::dvec3{ RegionWidth * Chunk::Extents::CHUNK_WIDTH };
+        }
+
+        static glm::dvec3 chunk_min(ChunkIndex const& index) noexcept
+        {
+            return glm::dvec3{ index } * Chunk::Extents::CHUNK_WIDTH;
+        }
+
+    public:
+        size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        size_t region_count() const noexcept { return m_regions.size(); }
+
+        // Returns false if there already is a value for the index
+        bool insert(ChunkIndex const& index, T value)
+        {
+            auto& region = m_regions[region_of(index)];
+            auto& slot = region.Slots[slot_of(index)];
+            if (slot != NoSlot)
+                return false;
+
+            slot = static_cast<uint16_t>(region.Values.size());
+            region.Values.emplace_back(index, std::move(value));
+            m_size++;
+            return true;
+        }
+
+        // Returns false if there is no value for the index
+        bool erase(ChunkIndex const& index)
+        {
+            auto it = m_regions.find(region_of(index));
+            if (it == std::end(m_regions))
+                return false;
+
+            auto& region = it->second;
+            auto slot = region.Slots[slot_of(index)];
+            if (slot == NoSlot)
+                return false;
+
+            // Move the last value of the region into the hole
+            region.Slots[slot_of(index)] = NoSlot;
+            if (slot != region.Values.size() - 1)
+            {
+                region.Values[slot] = std::move(region.Values.back());
+                region.Slots[slot_of(region.Values[slot].first)] = slot;
+            }
+            region.Values.pop_back();
+            m_size--;
+
+            if (region.Values.empty())
+                m_regions.erase(it);
+            return true;
+        }
+
+        T* find(ChunkIndex const& index)
+        {
+            auto it = m_regions.find(region_of(index));
+            if (it == std::end(m_regions))
+                return nullptr;
+
+            auto slot = it->second.Slots[slot_of(index)];
+            return slot == NoSlot ? nullptr : &it->second.Values[slot].second;
+        }
+
+        void clear()
+        {
+            m_regions.clear();
+            m_size = 0;
+        }
+
+        // Calls f(index, value) for every value
+        template <typename F>
+        void for_each(F&& f) const
+        {
+            for (auto const& [region_index, region] : m_regions)
+            {
+                for (auto const& [index, value] : region.Values)
+                    f(index, value);
+            }
+        }
+
+        // Calls f(index, value) for the chunks whose box intersects the frustum
+        template <typename F>
+        void for_each_in_frustum(Frustum const& frustum, F&& f) const
+        {
+            for (auto const& [region_index, region] : m_regions)
+            {
+                glm::vec3 min{ region_min(region_index) }, max{ region_max(region_index) };
+                if (!frustum.intersects_box(min, max))
+                    continue;
+
+                bool inside = frustum.contains_box(min, max);
+                for (auto const& [index, value] : region.Values)
+                {
+                    glm::vec3 chunk_min_position{ chunk_min(index) };
+                    if (inside || frustum.intersects_box(chunk_min_position, chunk_min_position + glm::vec3{ Chunk::Extents::CHUNK_WIDTH }))
+                        f(index, value);
+                }
+            }
+        }
+
+        // Calls f(index, value) for the chunks whose center is farther than
+        // distance from position, until f returns false
+        template <typename F>
+        void for_each_beyond(glm::dvec3 const& position, double distance, F&& f) const
+        {
+            for (auto const& [region_index, region] : m_regions)
+            {
+                // Skip the regions whose farthest point is within distance
+                auto min = region_min(region_index), max = region_max(region_index);
+                auto farthest = glm::max(glm::abs(position - min), glm::abs(position - max));
+                if (glm::length(farthest) <= distance)
+                    continue;
+
+                for (auto const& [index, value] : region.Values)
+                {
+                    auto center = chunk_min(index) + Chunk::Extents::center_offset();
+                    if (glm::distance(center, position) > distance && !f(index, value))
+                        return;
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "chunk.h"
+
+namespace tarragon
+{
+    enum class MeshingMode
+    {
+        // One quad per exposed block face
+        Naive,
+        // Coplanar exposed faces of the same block type are merged into
+        // maximal rectangles, with texture coordinates that repeat once per block
+        Greedy,
+    };
+
+    // Creates the mesh of the exposed block faces of a chunk
+    ChunkMesh generate_mesh(Chunk const& chunk, MeshingMode mode);
+}
@@ -1,31 +1,37 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+#include <slotmap.h>
+
 #include "glad/gl.h"
 #include "component.h"
 #include "chunk.h"
 #include "camera.h"
 #include "shader.h"
+#include "stagingring.h"
+#include "geometryarena.h"
+#include "chunkculler.h"
+#include "chunkgrid.h"
 #include "chunktransfer.h"
 
 namespace tarragon
 {
+    // The range of a chunk's vertices in the vertex arena of the renderer
     class ChunkBindings
     {
     private:
         Chunk::Extents m_chunk_extents;
+        GeometryArena* m_pvertex_arena;
 
-        GLuint m_vao{};
-        GLuint m_position_buffer{};
-        GLuint m_normal_buffer{};
-        GLuint m_texcoord_buffer{};
-        GLuint m_index_buffer{};
+        size_t m_first_vertex{};
+        size_t m_vertex_count{};
         GLsizei m_index_count{};
-        glm::mat4 m_model{};
+        glm::vec3 m_world_position{};
 
     //public:
     //    GLuint m_normal_vao{};
@@ -33,47 +39,103 @@ namespace tarragon
     //    GLsizei m_normalline_count{};
 
     public:
-        ChunkBindings(Chunk::Extents const& chunk_extents);
+        ChunkBindings(Chunk::Extents const& chunk_extents, GeometryArena* pvertex_arena);
+        // Returns the vertices to the arena
         ~ChunkBindings();
 
         ChunkBindings(ChunkBindings const&) = delete;
         ChunkBindings& operator= (ChunkBindings const&) = delete;
 
-        void upload(const ChunkMesh *pdata);
+        // The moved-from bindings no longer own their vertices
+        ChunkBindings(ChunkBindings&& other) noexcept;
+        ChunkBindings& operator= (ChunkBindings&& other) noexcept;
+
+        // Uploads the mesh into the vertex arena, to be drawn with the shared
+        // quad index buffer. Staged vertices are copied from the staging
+        // ring, and their region is retired.
+        void upload(const ChunkMesh *pdata, StagingRing& staging_ring);
 
         Chunk::Extents const& chunk_extents() const noexcept { return m_chunk_extents; }
 
-        GLuint vao() const noexcept { return m_vao; }
+        GLint base_vertex() const noexcept { return static_cast<GLint>(m_first_vertex); }
         GLsizei index_count() const noexcept { return m_index_count; }
-        glm::mat4 const& model() const noexcept { return m_model; }
+        glm::vec3 const& world_position() const noexcept { return m_world_position; }
     };
-    using ChunkBindingsPtr = std::shared_ptr<ChunkBindings>;
 
 
+    enum class CullingMode
+    {
+        // Chunks are culled by a compute pass, see ChunkCuller
+        Gpu,
+        // Chunks are culled against the view frustum on the CPU, using a
+        // spatial index of the rendered chunks
+        Cpu,
+    };
+
     class ChunkRenderer : public UpdateComponent, public DrawComponent
     {
     private:
+        // Maximum number of chunks uploaded, and unloaded, per frame. Most
+        // uploads are only a copy out of the staging ring.
+        static constexpr size_t MaxChunksPerFrame = 256;
+        static constexpr size_t StagingRingCapacity = 16 * 1024 * 1024;
+        // In vertices, the arena grows when full
+        static constexpr size_t VertexArenaCapacity = 4 * 1024 * 1024;
+        // Initial number of draw commands, doubled when exceeded
+        static constexpr size_t MinDrawCapacity = 1024;
+
         Camera* m_pcamera;
         ChunkTransfer* m_pchunk_transfer;
+        CullingMode m_culling_mode;
 
         Shader m_shader;
         //Shader m_normal_shader;
-        std::vector<ChunkBindingsPtr> m_bindings;
 
+        // Written by the mesh jobs, see ChunkUpdater
+        std::unique_ptr<StagingRing> m_pstaging_ring;
+        // Vertices of all chunks, drawn with a single VAO
+        std::unique_ptr<GeometryArena> m_pvertex_arena;
+        // The bindings of the rendered chunks, found by chunk index
+        SlotMap<ChunkBindings> m_bindings;
+        ChunkGrid<SlotMap<ChunkBindings>::Handle> m_binding_handles;
+        GLuint m_vao{};
+        // Indices of Chunk::MAX_QUADS quads, shared by all chunk meshes
+        GLuint m_quad_index_buffer{};
         GLuint m_rock_texture{};
 
+        // One draw command per chunk with a mesh, and the origin of the
+        // chunk at the index given by its base instance. With GPU culling,
+        // both hold all chunks and are rebuilt when chunks are added or
+        // removed. With CPU culling, they hold the visible chunks and are
+        // rebuilt every frame.
+        std::vector<DrawElementsIndirectCommand> m_draw_commands;
+        std::vector<glm::vec4> m_chunk_origins;
+        bool m_draws_changed{};
+        size_t m_draw_capacity{};
+        GLuint m_draw_command_buffer{};
+        GLuint m_chunk_origin_buffer{};
+        ChunkCuller m_culler;
+
+        void add_draw(ChunkBindings const& bindings);
+        // Uploads the draw commands and chunk origins
+        void upload_draws();
+
     public:
-        ChunkRenderer(Camera *pcamera, ChunkTransfer* ptransfer)
+        ChunkRenderer(Camera *pcamera, ChunkTransfer* ptransfer, CullingMode culling_mode = CullingMode::Gpu)
             : m_pcamera{ pcamera }
             , m_pchunk_transfer{ ptransfer }
+            , m_culling_mode{ culling_mode }
         { }
-        virtual ~ChunkRenderer() = default;
+        virtual ~ChunkRenderer();
 
         ChunkRenderer(ChunkRenderer const&) = delete;
         ChunkRenderer& operator= (ChunkRenderer const&) = delete;
 
         virtual void initialize() override;
 
+        // Created by initialize()
+        StagingRing* staging_ring() const noexcept { return m_pstaging_ring.get(); }
+
         virtual void update(Clock const& clock) override;
         virtual void draw() override;
     };
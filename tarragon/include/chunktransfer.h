@@ -1,62 +1,116 @@
 #pragma once
 
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
-#include <queue>
 #include <mutex>
-#include <set>
+#include <span>
+#include <stop_token>
+#include <vector>
 
 #include <glm/geometric.hpp>
 
+#include "boundedqueue.h"
 #include "common.h"
+#include "histogram.h"
 #include "component.h"
 #include "chunk.h"
 #include "camera.h"
 #include "chunkcache.h"
+#include "chunkgrid.h"
+#include "frustum.h"
 
 namespace tarragon
 {
 	class ChunkTransfer : public UpdateComponent
 	{
 	private:
-		struct ChunkDistance
+		struct LoadRequest
 		{
-			Camera* m_pcamera;
+			Chunk* Target;
+			// Lower values are loaded first
+			float Priority;
+			std::chrono::steady_clock::time_point EnqueueTime;
+		};
 
-			bool operator()(const Chunk* lhs, const Chunk* rhs) const
+		struct LoadOrder
+		{
+			bool operator()(LoadRequest const& lhs, LoadRequest const& rhs) const
 			{
-				assert(lhs != nullptr);
-				assert(rhs != nullptr);
-				return glm::distance(m_pcamera->position(), glm::vec3{ lhs->center() }) > glm::distance(m_pcamera->position(), glm::vec3{ rhs->center() });
+				return lhs.Priority > rhs.Priority;
 			}
+		};
+
+		// Snapshot of the camera that load priorities were computed for
+		//
+		// The priority of a chunk is its distance to the camera. Chunks outside
+		// of the view frustum are weighted by OutOfViewWeight, so that the
+		// visible terrain is loaded first.
+		struct LoadPriority
+		{
+			static constexpr float OutOfViewWeight = 3.0f;
+			static constexpr float ChunkRadius = static_cast<float>(Chunk::Extents::CHUNK_WIDTH * 0.8660254037844386);
+
+			glm::vec3 Position;
+			glm::vec3 Forward;
+			Frustum ViewFrustum;
+
+			float operator()(Chunk const* pchunk) const
+			{
+				assert(pchunk != nullptr);
 
-			ChunkDistance(Camera* pcamera)
-				: m_pcamera{ pcamera }
-			{ }
+				glm::vec3 center{ pchunk->center() };
+				auto distance = glm::distance(Position, center);
+				return ViewFrustum.intersects_sphere(center, ChunkRadius) ? distance : distance * OutOfViewWeight;
+			}
 		};
 
 		static constexpr double ChunkLoadDistance = 30.0;
 		static constexpr double ChunkUnloadThreshold = 60.0;
 
+		static constexpr size_t FinishedQueueCapacity = 4096;
+		static constexpr size_t UnloadQueueCapacity = 4096;
+
 		Camera* m_pcamera;
 		ChunkCache* m_pchunk_cache;
 
-		std::mutex m_queue_mtx;
-		std::priority_queue<Chunk*, std::vector<Chunk*>, ChunkDistance> m_load_queue;
-		std::queue<Chunk*> m_finished_queue;
-		std::queue<Chunk*> m_unload_queue;
+		// Each stage has its own queue, so that workers finishing chunks don't
+		// contend with the main thread queueing chunks for loading.
+		// The load queue is a heap ordered by the priorities in m_load_priority.
+		// It is reordered when the camera moves, instead of comparing against
+		// the live camera, which would break the heap order.
+		std::mutex m_load_mtx;
+		std::condition_variable_any m_load_cv;
+		std::vector<LoadRequest> m_load_queue;
+		LoadPriority m_load_priority;
+
+		BoundedQueue<Chunk*> m_finished_queue;
+		BoundedQueue<Chunk*> m_unload_queue;
+
+		// Only used on the main thread
+		ChunkGrid<Chunk*> m_rendering_chunks;
 
-		std::set<Chunk*> m_rendering_chunks;
+		// Time from enqueue_to_load to dequeueing the chunk
+		LatencyHistogram m_load_latency;
+
+		Chunk* pop_load_queue();
+
+		// Recomputes the load priorities if the camera moved or turned
+		void update_load_priorities();
 
 	public:
 		ChunkTransfer(Camera* pcamera, ChunkCache* pcache)
 			: m_pcamera{ pcamera }
 			, m_pchunk_cache{ pcache }
-			, m_queue_mtx{}
-			, m_load_queue{ ChunkDistance{ pcamera }, {} }
-			, m_finished_queue{}
-			, m_unload_queue{}
+			, m_load_mtx{}
+			, m_load_cv{}
+			, m_load_queue{}
+			, m_load_priority{ pcamera->position(), pcamera->forward(), pcamera->frustum() }
+			, m_finished_queue{ FinishedQueueCapacity }
+			, m_unload_queue{ UnloadQueueCapacity }
 			, m_rendering_chunks{}
+			, m_load_latency{}
 		{
 
 		}
@@ -73,12 +127,26 @@ namespace tarragon
 		virtual void update(Clock const& clock) override;
 
 		void enqueue_to_load(Chunk* pchunk);
+		void enqueue_to_load(std::span<Chunk* const> pchunks);
 		bool dequeue_to_load(Chunk** ppchunk);
 
+		// Waits until a chunk is queued for loading and dequeues it. Returns
+		// false without a chunk if stop is requested first.
+		bool wait_dequeue_to_load(Chunk** ppchunk, std::stop_token stop_token);
+
+		LatencyHistogram const& load_latency() const noexcept { return m_load_latency; }
+
+		// Queues a finished chunk for rendering. Waits for the main thread to
+		// dequeue chunks if the queue is full.
 		void enqueue_to_render(Chunk* pchunk);
 		bool dequeue_to_render(Chunk** ppchunk);
+		// Dequeues up to ppchunks.size() chunks, returns the number dequeued
+		size_t dequeue_to_render(std::span<Chunk*> ppchunks);
 
-		void enqueue_to_unload(Chunk* pchunk);
+		// Queues a chunk for unloading, returns false if the queue is full
+		bool enqueue_to_unload(Chunk* pchunk);
 		bool dequeue_to_unload(Chunk** ppchunk);
+		// Dequeues up to ppchunks.size() chunks, returns the number dequeued
+		size_t dequeue_to_unload(std::span<Chunk*> ppchunks);
 	};
 }
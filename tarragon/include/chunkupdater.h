@@ -1,39 +1,81 @@
 #pragma once
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <stop_token>
 #include <thread>
 
+#include <jobpool.h>
+
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
 #include "common.h"
 #include "component.h"
 #include "chunk.h"
+#include "chunkmesher.h"
 #include "chunktransfer.h"
+#include "stagingring.h"
 #include "world.h"
 
 namespace tarragon
 {
+    // Generates and meshes the chunks queued for loading
+    //
+    // Every stage of a chunk runs as a separate job on a work-stealing job
+    // pool. A feed thread takes chunks from the load queue while fewer than
+    // MaxChunksPerWorker chunks per worker are in flight, so the nearest
+    // chunks are still picked first when the camera moves. The feed thread
+    // blocks while there is nothing to do, and wakes as soon as a chunk is
+    // queued, a chunk slot frees up or the updater is destroyed.
+    //
+    // Mesh jobs write the vertices straight into the staging ring, if given
+    // one with enough room, so the main thread only has to copy them.
+    // Chunks that turn out empty after generation, or whose mesh has no
+    // faces, skip the remaining stages and are ready without a mesh.
     class ChunkUpdater : public UpdateComponent
     {
     private:
+        static constexpr size_t MaxChunksPerWorker = 2;
+
         ChunkTransfer* m_pchunk_transfer;
+        StagingRing* m_pstaging_ring;
 
-        std::jthread m_work_thread_0;
-        std::jthread m_work_thread_1;
-        
         std::unique_ptr<World> m_pworld;
+        MeshingMode m_meshing_mode;
+
+        std::mutex m_chunk_slots_mtx;
+        std::condition_variable_any m_chunk_slots_cv;
+        size_t m_free_chunk_slots;
+
+        JobPool m_job_pool;
+        std::jthread m_feed_thread;
+
+        void generate_data_job(Chunk* pchunk);
+        void generate_mesh_job(Chunk* pchunk);
+
+        // Moves the vertices of the mesh to the staging ring, if there is room
+        void stage_vertices(ChunkMesh& mesh);
 
-        ChunkMesh generate_mesh(Chunk* chunk);
+        // Waits until fewer than the maximum number of chunks are in flight
+        // and takes a slot. Returns false if stop is requested first.
+        bool acquire_chunk_slot(std::stop_token stop_token);
+        void release_chunk_slot();
 
-        void work_thread_loop();
+        void feed_thread_loop(std::stop_token stop_token);
 
     public:
-        ChunkUpdater(ChunkTransfer* ptransfer)
+        ChunkUpdater(ChunkTransfer* ptransfer, StagingRing* pstaging_ring = nullptr, MeshingMode meshing_mode = MeshingMode::Greedy, size_t worker_count = JobPool::default_worker_count())
             : m_pchunk_transfer{ ptransfer }
-            , m_work_thread_0{ &ChunkUpdater::work_thread_loop, this }
-            , m_work_thread_1{ &ChunkUpdater::work_thread_loop, this }
+            , m_pstaging_ring{ pstaging_ring }
             , m_pworld{ std::make_unique<World>() }
+            , m_meshing_mode{ meshing_mode }
+            , m_chunk_slots_mtx{}
+            , m_chunk_slots_cv{}
+            , m_free_chunk_slots{ worker_count * MaxChunksPerWorker }
+            , m_job_pool{ worker_count }
+            , m_feed_thread{ [this](std::stop_token stop_token) { feed_thread_loop(stop_token); } }
         {
 
         }
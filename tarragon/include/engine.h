@@ -32,12 +32,15 @@ namespace tarragon
         std::unique_ptr<Camera> m_pcamera;
         std::unique_ptr<FreelookCamera> m_pfreecam;
         std::unique_ptr<ChunkCache> m_pchunk_cache;
+        // Declared before the components using it, so that it's destroyed after them
+        std::unique_ptr<ChunkTransfer> m_pchunk_transfer;
         std::unique_ptr<ChunkRenderer> m_pchunk_renderer;
         std::unique_ptr<ChunkUpdater> m_pchunk_updater;
-        std::unique_ptr<ChunkTransfer> m_pchunk_transfer;
 
         bool initialize_components();
 
+        void draw_statistics();
+
     public:
         Engine() = default;
         Engine(Engine const&) = delete;
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+namespace tarragon
+{
+    // The volume visible to a camera, bounded by six planes
+    //
+    // The planes are extracted from a view-projection matrix with a clip
+    // space depth range of 0 to 1. Their normals point into the frustum.
+    class Frustum final
+    {
+    private:
+        // xyz is the normal, w the distance from the origin
+        std::array<glm::vec4, 6> m_planes{};
+
+    public:
+        Frustum() = default;
+
+        explicit Frustum(glm::mat4 const& view_projection)
+        {
+            auto row = [&](int i) { return glm::vec4{ view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i] }; };
+            auto x = row(0), y = row(1), z = row(2), w = row(3);
+
+            m_planes = { w + x, w - x, w + y, w - y, z, w - z };
+            for (auto& plane : m_planes)
+                plane /= glm::length(glm::vec3{ plane });
+        }
+
+        std::array<glm::vec4, 6> const& planes() const noexcept { return m_planes; }
+
+        bool intersects_sphere(glm::vec3 const& center, float radius) const noexcept
+        {
+            for (auto const& plane : m_planes)
+            {
+                if (glm::dot(glm::vec3{ plane }, center) + plane.w < -radius)
+                    return false;
+            }
+            return true;
+        }
+
+        // Conservative test of an axis-aligned box, which may report boxes
+        // near the corners of the frustum as intersecting
+        bool intersects_box(glm::vec3 const& min, glm::vec3 const& max) const noexcept
+        {
+            for (auto const& plane : m_planes)
+            {
+                // The corner furthest along the plane normal
+                glm::vec3 corner
+                {
+                    plane.x >= 0.0f ? max.x : min.x,
+                    plane.y >= 0.0f ? max.y : min.y,
+                    plane.z >= 0.0f ? max.z : min.z,
+                };
+                if (glm::dot(glm::vec3{ plane }, corner) + plane.w < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        // Whether an axis-aligned box lies entirely inside the frustum
+        bool contains_box(glm::vec3 const& min, glm::vec3 const& max) const noexcept
+        {
+            for (auto const& plane : m_planes)
+            {
+                // The corner furthest against the plane normal
+                glm::vec3 corner
+                {
+                    plane.x >= 0.0f ? min.x : max.x,
+                    plane.y >= 0.0f ? min.y : max.y,
+                    plane.z >= 0.0f ? min.z : max.z,
+                };
+                if (glm::dot(glm::vec3{ plane }, corner) + plane.w < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#include <rangeallocator.h>
+
+#include "glad/gl.h"
+
+namespace tarragon
+{
+    // One GPU buffer that the geometry of many meshes is sub-allocated from
+    //
+    // Ranges are counted in elements of element_size bytes, so that they can
+    // be used as base vertices. When no free range is large enough, the
+    // buffer is replaced by one twice as large, keeping the offsets of the
+    // allocated ranges. Needs the GL context.
+    class GeometryArena final
+    {
+    private:
+        size_t m_element_size;
+        GLuint m_buffer{};
+        RangeAllocator m_allocator;
+
+        void grow(size_t min_capacity);
+
+    public:
+        GeometryArena(size_t element_size, size_t capacity);
+        ~GeometryArena();
+
+        GeometryArena(GeometryArena const&) = delete;
+        GeometryArena& operator= (GeometryArena const&) = delete;
+
+        // Changes when the arena grows
+        GLuint buffer() const noexcept { return m_buffer; }
+        size_t element_size() const noexcept { return m_element_size; }
+        RangeAllocator const& allocator() const noexcept { return m_allocator; }
+
+        // Returns the offset of count elements, growing the buffer if needed
+        size_t allocate(size_t count);
+        void free(size_t offset, size_t count);
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <string_view>
 #include <vector>
 #include <fstream>
@@ -39,6 +40,7 @@ namespace tarragon
         void write(glm::vec4 const& value) { glUniform4fv(m_location, 1, glm::value_ptr(value)); }
         void write(glm::mat3 const& value) { glUniformMatrix3fv(m_location, 1, GL_FALSE, glm::value_ptr(value)); }
         void write(glm::mat4 const& value) { glUniformMatrix4fv(m_location, 1, GL_FALSE, glm::value_ptr(value)); }
+        void write(std::span<glm::vec4 const> values) { glUniform4fv(m_location, static_cast<GLsizei>(values.size()), glm::value_ptr(values.front())); }
     };
 
     class Shader final
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include "glad/gl.h"
+
+namespace tarragon
+{
+    // A persistently mapped, coherent buffer for streaming data to the GPU
+    //
+    // Any thread can allocate a region and write to it through data(). The
+    // main thread then copies the region into its destination buffer and
+    // retires it. fence() puts a fence behind all regions retired since the
+    // last call, and reclaim() frees the regions whose fences have signalled,
+    // so the GPU is never reading a region that is written again.
+    //
+    // Regions are freed in the order they were allocated, so a region that
+    // is never retired blocks the ring. Allocating fails instead of blocking
+    // when the ring is full.
+    //
+    // Creating, fencing, reclaiming and destroying need the GL context.
+    class StagingRing final
+    {
+    public:
+        static constexpr size_t Alignment = 16;
+
+    private:
+        struct Allocation
+        {
+            size_t Offset;
+            size_t End;
+            bool Retired;
+            // Fence serial the allocation waits for, 0 if not fenced yet
+            uint64_t Serial;
+        };
+
+        struct Fence
+        {
+            uint64_t Serial;
+            GLsync Sync;
+        };
+
+        size_t m_capacity;
+        GLuint m_buffer{};
+        std::byte* m_pmapped{};
+
+        // Guards the allocations, which are shared with the writing threads
+        std::mutex m_mtx;
+        std::deque<Allocation> m_allocations;
+        size_t m_head{};
+        size_t m_tail{};
+
+        // Only used on the main thread
+        std::deque<Fence> m_fences;
+        uint64_t m_next_serial{ 1 };
+        uint64_t m_signalled_serial{};
+
+    public:
+        explicit StagingRing(size_t capacity);
+        ~StagingRing();
+
+        StagingRing(StagingRing const&) = delete;
+        StagingRing& operator= (StagingRing const&) = delete;
+
+        GLuint buffer() const noexcept { return m_buffer; }
+        size_t capacity() const noexcept { return m_capacity; }
+
+        // Allocates size bytes, returns their offset into the buffer, or
+        // nothing if the ring has no room for them
+        std::optional<size_t> allocate(size_t size);
+        std::byte* data(size_t offset) const noexcept { return m_pmapped + offset; }
+
+        // Marks the region at offset as no longer written by the CPU, after
+        // the commands reading it are issued
+        void retire(size_t offset);
+
+        // Fences the regions retired since the last call
+        void fence();
+        // Frees the regions whose fences have signalled
+        void reclaim();
+    };
+}
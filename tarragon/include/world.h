@@ -1,5 +1,6 @@
 #pragma once
 
+#include <noise/graph.h>
 #include <noise/modules.h>
 #include "chunk.h"
 
@@ -8,14 +9,17 @@ namespace tarragon
 	class World
 	{
 	private:
-		Module m_source;
-		double m_air_threshold{ 0.1 };
+		FloatModule m_source;
+		float m_air_threshold{ 0.1f };
 
-		Block map_value(double value);
+		Block map_value(float value);
 
 	public:
 		World();
 
+		// The noise graph that blocks are generated from
+		static FloatModule terrain();
+
 		void generate_data(Chunk* pchunk);
 	};
 }
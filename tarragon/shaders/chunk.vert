@@ -1,10 +1,15 @@
 #version 460
 
-layout (location = 0) in vec3 pos;
-layout (location = 1) in vec3 normal;
-layout (location = 2) in vec2 texcoord;
+// Packed vertex, see ChunkVertex in chunk.h
+layout (location = 0) in uint vertex;
+
+// Origin of the chunk of each draw, indexed by the base instance of the
+// draw command, see ChunkRenderer::upload_draws
+layout (std430, binding = 0) readonly buffer ChunkOrigins
+{
+    vec4 Origins[];
+};
 
-uniform mat4 Model;
 uniform mat4 View;
 uniform mat4 Projection;
 
@@ -12,9 +17,22 @@ out vec3 vert_pos;
 out vec3 vert_normal;
 out vec2 tex_coords;
 
+const vec3 Normals[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0),  //right
+    vec3(-1.0, 0.0, 0.0), //left
+    vec3(0.0, 1.0, 0.0),  //top
+    vec3(0.0, -1.0, 0.0), //bottom
+    vec3(0.0, 0.0, 1.0),  //front
+    vec3(0.0, 0.0, -1.0)  //back
+);
+
 void main()
 {
-    vert_pos = vec3(Model * vec4(pos, 1.0));
+    vec3 pos = vec3(vertex & 31u, (vertex >> 5) & 31u, (vertex >> 10) & 31u);
+    vec3 normal = Normals[(vertex >> 15) & 7u];
+    vec2 texcoord = vec2((vertex >> 18) & 31u, (vertex >> 23) & 31u);
+
+    vert_pos = Origins[gl_BaseInstance].xyz + pos;
     vert_normal = normal;
     tex_coords = texcoord;
     
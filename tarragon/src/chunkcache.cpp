@@ -1,6 +1,9 @@
 #include "chunkcache.h"
 
 #include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
 
 #include <glm/geometric.hpp>
 
@@ -22,12 +25,6 @@ namespace tarragon
 		return get_chunk_origin(chunk_index) + Chunk::Extents::center_offset();
 	}
 
-	int64_t ChunkCache::get_chunk_index_hash(ChunkIndex const& chunk_index)
-	{
-		glm::u64vec3 ui{ chunk_index };
-		return static_cast<int64_t>((ui.x * P0 + ui.y) * P1 + ui.z);
-	}
-
 	Chunk* ChunkCache::get_chunk_at(glm::dvec3 const& world_pos)
 	{
 		auto chunk_index = get_chunk_index(world_pos);
@@ -36,20 +33,61 @@ namespace tarragon
 
 	Chunk* ChunkCache::get_chunk_at(ChunkIndex const& chunk_index)
 	{
-		auto chunk_hash = get_chunk_index_hash(chunk_index);
-
-		auto [first, last] = m_chunks.equal_range(chunk_hash);
-		for (; first != last; first++)
+		if (auto ppchunk = m_chunks.find(chunk_index))
 		{
-			auto candidate_index = get_chunk_index(first->second->center());
-			if (chunk_index == candidate_index)
-				return first->second.get();
+			m_hits++;
+			return *ppchunk;
 		}
 
 		// no chunk found, create it
-		auto chunk_origin = get_chunk_origin(chunk_index);
-		auto it = m_chunks.emplace(chunk_hash, std::make_unique<Chunk>(chunk_origin, chunk_index));
-		return it->second.get();
+		m_misses++;
+		auto pchunk = m_chunk_pool.create(get_chunk_origin(chunk_index), chunk_index);
+		m_chunks.try_emplace(chunk_index, pchunk);
+		return pchunk;
+	}
+
+	void ChunkCache::evict(glm::dvec3 const& world_pos)
+	{
+		if (m_chunks.size() <= m_max_chunks)
+			return;
+
+		std::vector<std::pair<double, Chunk*>> candidates{};
+		m_chunks.for_each([&](ChunkIndex const&, Chunk* pchunk)
+		{
+			if (pchunk->state() == ChunkState::Created)
+				candidates.emplace_back(glm::distance(world_pos, pchunk->center()), pchunk);
+		});
+
+		// the furthest chunks first
+		auto target = m_max_chunks - m_max_chunks / 8;
+		auto count = std::min(m_chunks.size() - target, candidates.size());
+		std::nth_element(std::begin(candidates), std::begin(candidates) + count, std::end(candidates),
+			[](auto const& a, auto const& b) { return a.first > b.first; });
+
+		for (size_t i = 0; i < count; i++)
+		{
+			auto pchunk = candidates[i].second;
+			m_chunks.erase(pchunk->chunk_index());
+			m_chunk_pool.destroy(pchunk);
+		}
+		m_evictions += count;
+	}
+
+	void ChunkCache::add_chunk_data(Chunk const* pchunk)
+	{
+		m_data_bytes += pchunk->data_heap_size();
+	}
+
+	void ChunkCache::remove_chunk_data(Chunk const* pchunk)
+	{
+		assert(m_data_bytes >= pchunk->data_heap_size());
+		m_data_bytes -= pchunk->data_heap_size();
+	}
+
+	ChunkCacheStatistics ChunkCache::statistics() const
+	{
+		auto bytes_held = m_chunk_pool.capacity() * sizeof(Chunk) + m_data_bytes;
+		return ChunkCacheStatistics{ m_chunks.size(), bytes_held, m_evictions, m_hits, m_misses };
 	}
 
 	std::vector<ChunkIndex> ChunkCache::chunk_indices_around(glm::dvec3 const& world_pos, double max_distance)
@@ -0,0 +1,156 @@
+#include "chunkculler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#include "chunk.h"
+
+namespace tarragon
+{
+    namespace
+    {
+        constexpr GLuint CullGroupSize = 64;
+        constexpr GLuint HiZGroupSize = 8;
+
+        constexpr GLuint group_count(size_t count, GLuint group_size)
+        {
+            return static_cast<GLuint>((count + group_size - 1) / group_size);
+        }
+    }
+
+    ChunkCuller::~ChunkCuller()
+    {
+        glDeleteBuffers(1, &m_visible_draw_buffer);
+        glDeleteBuffers(1, &m_draw_count_buffer);
+        glDeleteFramebuffers(1, &m_framebuffer);
+        glDeleteTextures(1, &m_color_texture);
+        glDeleteTextures(1, &m_depth_texture);
+        glDeleteTextures(1, &m_hiz_texture);
+    }
+
+    void ChunkCuller::initialize()
+    {
+        m_cull_shader.add_shader_from_file(ShaderType::Compute, { "shaders/chunk_cull.comp" });
+        m_cull_shader.link();
+
+        m_hiz_shader.add_shader_from_file(ShaderType::Compute, { "shaders/hiz.comp" });
+        m_hiz_shader.link();
+
+        glCreateBuffers(1, &m_draw_count_buffer);
+        glNamedBufferStorage(m_draw_count_buffer, sizeof(GLuint), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        glCreateFramebuffers(1, &m_framebuffer);
+    }
+
+    void ChunkCuller::cull(GLuint origin_buffer, GLuint draw_buffer, size_t draw_count, Frustum const& frustum)
+    {
+        if (draw_count > m_draw_capacity)
+        {
+            m_draw_capacity = std::max(draw_count, m_draw_capacity * 2);
+
+            glDeleteBuffers(1, &m_visible_draw_buffer);
+            glCreateBuffers(1, &m_visible_draw_buffer);
+            glNamedBufferStorage(m_visible_draw_buffer, sizeof(DrawElementsIndirectCommand) * m_draw_capacity, nullptr, 0);
+        }
+
+        GLuint zero{};
+        glClearNamedBufferData(m_draw_count_buffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+        m_cull_shader.use();
+        m_cull_shader["DrawCount"].write(static_cast<GLuint>(draw_count));
+        m_cull_shader["ChunkWidth"].write(static_cast<float>(Chunk::Extents::CHUNK_WIDTH));
+        m_cull_shader["FrustumPlanes"].write(std::span<glm::vec4 const>{ frustum.planes() });
+        m_cull_shader["UseHiZ"].write(m_hiz_valid ? 1 : 0);
+        if (m_hiz_valid)
+        {
+            m_cull_shader["HiZViewProjection"].write(m_hiz_view_projection);
+            glBindTextureUnit(0, m_hiz_texture);
+            m_cull_shader["HiZ"].write(0);
+        }
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, origin_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, draw_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_visible_draw_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_draw_count_buffer);
+        glDispatchCompute(group_count(draw_count, CullGroupSize), 1, 1);
+
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    void ChunkCuller::resize_framebuffer(int width, int height)
+    {
+        m_width = width;
+        m_height = height;
+        m_hiz_valid = false;
+
+        glDeleteTextures(1, &m_color_texture);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_color_texture);
+        glTextureStorage2D(m_color_texture, 1, GL_RGBA8, width, height);
+
+        glDeleteTextures(1, &m_depth_texture);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_depth_texture);
+        glTextureStorage2D(m_depth_texture, 1, GL_DEPTH_COMPONENT32F, width, height);
+        glTextureParameteri(m_depth_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(m_depth_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glNamedFramebufferTexture(m_framebuffer, GL_COLOR_ATTACHMENT0, m_color_texture, 0);
+        glNamedFramebufferTexture(m_framebuffer, GL_DEPTH_ATTACHMENT, m_depth_texture, 0);
+        assert(glCheckNamedFramebufferStatus(m_framebuffer, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+        auto hiz_width = std::max(width / 2, 1);
+        auto hiz_height = std::max(height / 2, 1);
+        m_hiz_levels = static_cast<GLsizei>(std::bit_width(static_cast<unsigned>(std::max(hiz_width, hiz_height))));
+
+        glDeleteTextures(1, &m_hiz_texture);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_hiz_texture);
+        glTextureStorage2D(m_hiz_texture, m_hiz_levels, GL_R32F, hiz_width, hiz_height);
+        glTextureParameteri(m_hiz_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTextureParameteri(m_hiz_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(m_hiz_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(m_hiz_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    void ChunkCuller::bind_framebuffer(int width, int height)
+    {
+        // A minimized window has no pixels, but the attachments need some
+        width = std::max(width, 1);
+        height = std::max(height, 1);
+        if (width != m_width || height != m_height)
+            resize_framebuffer(width, height);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    void ChunkCuller::unbind_framebuffer()
+    {
+        glBlitNamedFramebuffer(m_framebuffer, 0, 0, 0, m_width, m_height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void ChunkCuller::build_hiz(glm::mat4 const& view_projection)
+    {
+        m_hiz_shader.use();
+        m_hiz_shader["Source"].write(0);
+
+        auto level_width = m_width, level_height = m_height;
+        for (GLint level = 0; level < m_hiz_levels; level++)
+        {
+            // The first level is reduced from the depth texture, every other
+            // level from the one before it
+            glBindTextureUnit(0, level == 0 ? m_depth_texture : m_hiz_texture);
+            m_hiz_shader["SourceLevel"].write(level == 0 ? 0 : level - 1);
+            glBindImageTexture(0, m_hiz_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            level_width = std::max(level_width / 2, 1);
+            level_height = std::max(level_height / 2, 1);
+            glDispatchCompute(group_count(static_cast<size_t>(level_width), HiZGroupSize), group_count(static_cast<size_t>(level_height), HiZGroupSize), 1);
+
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+
+        m_hiz_view_projection = view_projection;
+        m_hiz_valid = true;
+    }
+}
@@ -0,0 +1,289 @@
+#include "chunkmesher.h"
+
+#include <algorithm>
+#include <array>
+
+#include <glm/vec2.hpp>
+
+namespace tarragon
+{
+    namespace
+    {
+        using QuadArray = std::array<glm::ivec3, 4>;
+
+        static constexpr std::array<glm::ivec3, 6> Neighbours6
+        {
+            glm::ivec3{ 1, 0, 0 },  //right
+            glm::ivec3{ -1, 0, 0 }, //left
+            glm::ivec3{ 0, 1, 0 },  //top
+            glm::ivec3{ 0, -1, 0 }, //bottom
+            glm::ivec3{ 0, 0, 1 },  //front
+            glm::ivec3{ 0, 0, -1 }, //back
+        };
+
+        static constexpr std::array<QuadArray, 6> NeighbourFaces
+        {
+            QuadArray //right
+            {
+                glm::ivec3{ 1, 1, 1 },
+                glm::ivec3{ 1, 1, 0 },
+                glm::ivec3{ 1, 0, 1 },
+                glm::ivec3{ 1, 0, 0 },
+            },
+            QuadArray //left
+            {
+                glm::ivec3{ 0, 1, 0 },
+                glm::ivec3{ 0, 1, 1 },
+                glm::ivec3{ 0, 0, 0 },
+                glm::ivec3{ 0, 0, 1 },
+            },
+            QuadArray //top
+            {
+                glm::ivec3{ 0, 1, 0 },
+                glm::ivec3{ 1, 1, 0 },
+                glm::ivec3{ 0, 1, 1 },
+                glm::ivec3{ 1, 1, 1 },
+            },
+            QuadArray //bottom
+            {
+                glm::ivec3{ 1, 0, 0 },
+                glm::ivec3{ 0, 0, 0 },
+                glm::ivec3{ 1, 0, 1 },
+                glm::ivec3{ 0, 0, 1 },
+            },
+            QuadArray //front
+            {
+                glm::ivec3{ 0, 1, 1 },
+                glm::ivec3{ 1, 1, 1 },
+                glm::ivec3{ 0, 0, 1 },
+                glm::ivec3{ 1, 0, 1 },
+            },
+            QuadArray //back
+            {
+                glm::ivec3{ 1, 1, 0 },
+                glm::ivec3{ 0, 1, 0 },
+                glm::ivec3{ 1, 0, 0 },
+                glm::ivec3{ 0, 0, 0 },
+            },
+        };
+
+        static constexpr std::array<glm::uvec2, 4> FaceTexCoords
+        {
+            glm::uvec2{ 0, 0 },
+            glm::uvec2{ 1, 0 },
+            glm::uvec2{ 0, 1 },
+            glm::uvec2{ 1, 1 },
+        };
+
+        constexpr int Width = static_cast<int>(Chunk::WIDTH);
+
+        // Gets the index of the axis along which an offset points
+        constexpr int axis_of(glm::ivec3 const& offset)
+        {
+            return offset.x != 0 ? 0 : (offset.y != 0 ? 1 : 2);
+        }
+
+        // The block types of a chunk, surrounded by the blocks of the
+        // neighbouring chunks that touch its faces, so that neighbours of the
+        // blocks at the chunk border can be looked up without bounds checks.
+        // The edges and corners of the padding are air, meshing never reads them.
+        class PaddedBlocks final
+        {
+        private:
+            static constexpr int PaddedWidth = Width + 2;
+
+            std::array<BlockType, PaddedWidth * PaddedWidth * PaddedWidth> m_types{};
+
+        public:
+            explicit PaddedBlocks(Chunk const& chunk)
+            {
+                auto const& data = chunk.data();
+                for (int z = 0; z < Width; z++)
+                {
+                    for (int y = 0; y < Width; y++)
+                    {
+                        auto source = Chunk::index_for(glm::size3{ 0, y, z });
+                        auto target = index_for(glm::ivec3{ 0, y, z });
+                        for (int x = 0; x < Width; x++)
+                            m_types[target + x] = data.at(source + x).Type;
+                    }
+                }
+
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    for (int side : { -1, Width })
+                    {
+                        for (int v = 0; v < Width; v++)
+                        {
+                            for (int u = 0; u < Width; u++)
+                            {
+                                glm::ivec3 position{};
+                                position[axis] = side;
+                                position[(axis + 1) % 3] = u;
+                                position[(axis + 2) % 3] = v;
+                                m_types[index_for(position)] = chunk.border_at(position).Type;
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Gets the index of a position from -1 to Width
+            static constexpr int index_for(glm::ivec3 const& position) noexcept
+            {
+                return ((position.z + 1) * PaddedWidth + (position.y + 1)) * PaddedWidth + (position.x + 1);
+            }
+
+            // Gets the difference between the indices of neighbouring positions
+            static constexpr int stride_of(glm::ivec3 const& offset) noexcept
+            {
+                return (offset.z * PaddedWidth + offset.y) * PaddedWidth + offset.x;
+            }
+
+            BlockType operator[](int index) const noexcept { return m_types[index]; }
+            BlockType at(glm::ivec3 const& position) const noexcept { return m_types[index_for(position)]; }
+        };
+
+        // Adds the quad of a face that covers extent blocks, starting at position
+        void add_quad(ChunkMesh& data, size_t face, glm::ivec3 const& position, glm::ivec3 const& extent)
+        {
+            auto const& quad = NeighbourFaces.at(face);
+
+            // The texture runs from the first corner to the second in x, and to the third in y.
+            glm::uvec2 tex_scale
+            {
+                static_cast<uint32_t>(extent[axis_of(quad.at(1) - quad.at(0))]),
+                static_cast<uint32_t>(extent[axis_of(quad.at(2) - quad.at(0))]),
+            };
+
+            for (size_t j = 0; j < quad.size(); j++)
+            {
+                auto corner = glm::uvec3{ position + quad.at(j) * extent };
+                data.Vertices.push_back(ChunkVertex::pack(corner, static_cast<uint32_t>(face), FaceTexCoords.at(j) * tex_scale));
+            }
+        }
+
+        ChunkMesh generate_naive_mesh(PaddedBlocks const& blocks)
+        {
+            ChunkMesh data{};
+
+            for (int z = 0; z < Width; z++)
+            {
+                for (int y = 0; y < Width; y++)
+                {
+                    for (int x = 0; x < Width; x++)
+                    {
+                        glm::ivec3 position{ x, y, z };
+                        if (blocks.at(position) == BlockType::Air)
+                            continue;
+
+                        for (size_t i = 0; i < Neighbours6.size(); i++)
+                        {
+                            if (blocks.at(position + Neighbours6.at(i)) == BlockType::Air)
+                                add_quad(data, i, position, glm::ivec3{ 1 });
+                        }
+                    }
+                }
+            }
+
+            return data;
+        }
+
+        ChunkMesh generate_greedy_mesh(PaddedBlocks const& blocks)
+        {
+            ChunkMesh data{};
+
+            // Block types of the exposed faces in one slice, air where there is no face
+            std::array<BlockType, Chunk::WIDTH * Chunk::WIDTH> mask{};
+
+            for (size_t face = 0; face < Neighbours6.size(); face++)
+            {
+                auto const& offset = Neighbours6.at(face);
+
+                // Slices are perpendicular to the face normal, spanned by axes u and v.
+                auto d = axis_of(offset);
+                auto u = (d + 1) % 3;
+                auto v = (d + 2) % 3;
+
+                glm::ivec3 u_offset{}, v_offset{};
+                u_offset[u] = 1;
+                v_offset[v] = 1;
+                auto neighbour_stride = PaddedBlocks::stride_of(offset);
+                auto u_stride = PaddedBlocks::stride_of(u_offset);
+                auto v_stride = PaddedBlocks::stride_of(v_offset);
+
+                for (int slice = 0; slice < Width; slice++)
+                {
+                    glm::ivec3 slice_origin{};
+                    slice_origin[d] = slice;
+                    auto row_index = PaddedBlocks::index_for(slice_origin);
+
+                    for (int j = 0; j < Width; j++, row_index += v_stride)
+                    {
+                        auto index = row_index;
+                        for (int i = 0; i < Width; i++, index += u_stride)
+                        {
+                            auto type = blocks[index];
+                            mask[j * Width + i] = blocks[index + neighbour_stride] == BlockType::Air ? type : BlockType::Air;
+                        }
+                    }
+
+                    for (int j = 0; j < Width; j++)
+                    {
+                        for (int i = 0; i < Width;)
+                        {
+                            auto type = mask[j * Width + i];
+                            if (type == BlockType::Air)
+                            {
+                                i++;
+                                continue;
+                            }
+
+                            // Grow the rectangle along u, then along v while whole rows match.
+                            int width = 1;
+                            while (i + width < Width && mask[j * Width + i + width] == type)
+                                width++;
+
+                            int height = 1;
+                            while (j + height < Width)
+                            {
+                                auto row = std::begin(mask) + (j + height) * Width + i;
+                                if (!std::all_of(row, row + width, [type](BlockType other) { return other == type; }))
+                                    break;
+                                height++;
+                            }
+
+                            glm::ivec3 position{}, extent{ 1 };
+                            position[d] = slice;
+                            position[u] = i;
+                            position[v] = j;
+                            extent[u] = width;
+                            extent[v] = height;
+                            add_quad(data, face, position, extent);
+
+                            for (int row = j; row < j + height; row++)
+                                std::fill_n(std::begin(mask) + row * Width + i, width, BlockType::Air);
+                            i += width;
+                        }
+                    }
+                }
+            }
+
+            return data;
+        }
+    }
+
+    ChunkMesh generate_mesh(Chunk const& chunk, MeshingMode mode)
+    {
+        if (chunk.is_empty())
+            return ChunkMesh{ glm::vec3{ chunk.extents().origin() } };
+
+        PaddedBlocks blocks{ chunk };
+        auto data = mode == MeshingMode::Greedy
+            ? generate_greedy_mesh(blocks)
+            : generate_naive_mesh(blocks);
+
+        data.WorldPosition = glm::vec3{ chunk.extents().origin() };
+        return data;
+    }
+}
@@ -1,6 +1,11 @@
 #include "chunkrenderer.h"
 
-#include <glm/ext/matrix_transform.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "glad/gl.h"
 #include "stb/stb_image.h"
@@ -8,72 +13,107 @@
 
 namespace tarragon
 {
-    ChunkBindings::ChunkBindings(Chunk::Extents const& chunk_extents)
-        : m_chunk_extents{ chunk_extents }
+    namespace
     {
-        glCreateVertexArrays(1, &m_vao);
-        glCreateBuffers(1, &m_position_buffer);
-        glCreateBuffers(1, &m_normal_buffer);
-        glCreateBuffers(1, &m_texcoord_buffer);
-        glCreateBuffers(1, &m_index_buffer);
+        // Every vertex of a mesh must be addressable by a 16 bit index
+        static_assert(Chunk::MAX_QUADS * ChunkMesh::VerticesPerQuad <= 0x10000);
+
+        // Triangles 0,1,2 and 1,3,2 of each quad, see ChunkMesh
+        static constexpr std::array<uint16_t, ChunkMesh::IndicesPerQuad> QuadIndexOffsets{ 0, 1, 2, 1, 3, 2 };
+
+        // The indices of the quads of any mesh
+        std::vector<uint16_t> make_quad_indices()
+        {
+            std::vector<uint16_t> indices{};
+            indices.reserve(Chunk::MAX_QUADS * ChunkMesh::IndicesPerQuad);
+            for (size_t quad = 0; quad < Chunk::MAX_QUADS; quad++)
+            {
+                auto index = static_cast<uint16_t>(quad * ChunkMesh::VerticesPerQuad);
+                for (auto offset : QuadIndexOffsets)
+                    indices.push_back(static_cast<uint16_t>(index + offset));
+            }
+            return indices;
+        }
+    }
 
+    ChunkBindings::ChunkBindings(Chunk::Extents const& chunk_extents, GeometryArena* pvertex_arena)
+        : m_chunk_extents{ chunk_extents }
+        , m_pvertex_arena{ pvertex_arena }
+    {
         //glCreateVertexArrays(1, &m_normal_vao);
         //glCreateBuffers(1, &m_normalline_buffer);
     }
 
     ChunkBindings::~ChunkBindings()
     {
-        glDeleteVertexArrays(1, &m_vao);
-        glDeleteBuffers(1, &m_position_buffer);
-        glDeleteBuffers(1, &m_normal_buffer);
-        glDeleteBuffers(1, &m_texcoord_buffer);
-        glDeleteBuffers(1, &m_index_buffer);
+        if (m_vertex_count > 0)
+            m_pvertex_arena->free(m_first_vertex, m_vertex_count);
 
         //glDeleteVertexArrays(1, &m_normal_vao);
         //glDeleteBuffers(1, &m_normalline_buffer);
     }
 
-    void ChunkBindings::upload(const ChunkMesh *pdata)
+    ChunkBindings::ChunkBindings(ChunkBindings&& other) noexcept
+        : m_chunk_extents{ other.m_chunk_extents }
+        , m_pvertex_arena{ other.m_pvertex_arena }
+        , m_first_vertex{ other.m_first_vertex }
+        , m_vertex_count{ std::exchange(other.m_vertex_count, 0) }
+        , m_index_count{ std::exchange(other.m_index_count, 0) }
+        , m_world_position{ other.m_world_position }
     {
-        m_model = glm::translate(glm::identity<glm::mat4>(), pdata->WorldPosition);
+    }
 
-        if (pdata->Positions.size() > 0)
+    ChunkBindings& ChunkBindings::operator= (ChunkBindings&& other) noexcept
+    {
+        if (this != &other)
         {
-            glNamedBufferStorage(m_position_buffer, sizeof(glm::vec3) * pdata->Positions.size(), pdata->Positions.data(), 0);
-            glNamedBufferStorage(m_normal_buffer, sizeof(glm::vec3) * pdata->Normals.size(), pdata->Normals.data(), 0);
-            glNamedBufferStorage(m_texcoord_buffer, sizeof(glm::vec2) * pdata->TexCoords.size(), pdata->TexCoords.data(), 0);
-
-            m_index_count = static_cast<GLsizei>(pdata->Indices.size());
-            glNamedBufferStorage(m_index_buffer, sizeof(uint32_t) * pdata->Indices.size(), pdata->Indices.data(), 0);
+            if (m_vertex_count > 0)
+                m_pvertex_arena->free(m_first_vertex, m_vertex_count);
+
+            m_chunk_extents = other.m_chunk_extents;
+            m_pvertex_arena = other.m_pvertex_arena;
+            m_first_vertex = other.m_first_vertex;
+            m_vertex_count = std::exchange(other.m_vertex_count, 0);
+            m_index_count = std::exchange(other.m_index_count, 0);
+            m_world_position = other.m_world_position;
         }
+        return *this;
+    }
 
-        glVertexArrayElementBuffer(m_vao, m_index_buffer);
-
-        glEnableVertexArrayAttrib(m_vao, 0);
-        glVertexArrayVertexBuffer(m_vao, 0, m_position_buffer, 0, sizeof(glm::vec3));
-        glVertexArrayAttribFormat(m_vao, 0, 3, GL_FLOAT, GL_FALSE, 0);
+    void ChunkBindings::upload(const ChunkMesh *pdata, StagingRing& staging_ring)
+    {
+        assert(pdata->quad_count() <= Chunk::MAX_QUADS);
+        assert(m_vertex_count == 0);
 
-        glEnableVertexArrayAttrib(m_vao, 1);
-        glVertexArrayVertexBuffer(m_vao, 1, m_normal_buffer, 0, sizeof(glm::vec3));
-        glVertexArrayAttribFormat(m_vao, 1, 3, GL_FLOAT, GL_FALSE, 0);
+        m_world_position = pdata->WorldPosition;
 
-        glEnableVertexArrayAttrib(m_vao, 2);
-        glVertexArrayVertexBuffer(m_vao, 2, m_texcoord_buffer, 0, sizeof(glm::vec2));
-        glVertexArrayAttribFormat(m_vao, 2, 2, GL_FLOAT, GL_FALSE, 0);
+        m_vertex_count = pdata->vertex_count();
+        m_index_count = static_cast<GLsizei>(pdata->quad_count() * ChunkMesh::IndicesPerQuad);
+        if (m_vertex_count == 0)
+            return;
 
-        glVertexArrayAttribBinding(m_vao, 0, 0);
-        glVertexArrayAttribBinding(m_vao, 1, 1);
-        glVertexArrayAttribBinding(m_vao, 2, 2);
+        m_first_vertex = m_pvertex_arena->allocate(m_vertex_count);
+        auto offset = static_cast<GLintptr>(sizeof(ChunkVertex) * m_first_vertex);
+        auto size = static_cast<GLsizeiptr>(sizeof(ChunkVertex) * m_vertex_count);
+        if (pdata->Staged)
+        {
+            glCopyNamedBufferSubData(staging_ring.buffer(), m_pvertex_arena->buffer(), static_cast<GLintptr>(pdata->Staged->Offset), offset, size);
+            staging_ring.retire(pdata->Staged->Offset);
+        }
+        else
+        {
+            glNamedBufferSubData(m_pvertex_arena->buffer(), offset, size, pdata->Vertices.data());
+        }
 
-        //if (pdata->Positions.size() > 0)
+        //if (pdata->Vertices.size() > 0)
         //{
         //    std::vector<glm::vec3> normallines;
-        //    for (auto i = 0; i < pdata->Positions.size(); i++) {
+        //    for (auto i = 0; i < pdata->Vertices.size(); i++) {
         //        //retrieving the normal associated with this vertex
-        //        auto const& n = pdata->Normals[i];
+        //        auto n = pdata->Vertices[i].normal();
 
         //        //retrieving the vertex itself, it'll be the first point of our line
-        //        auto const& v1 = pdata->Positions[i];
+        //        auto v1 = pdata->Vertices[i].position();
 
         //        const auto normal_length = 0.5f;
         //        //second point of our line representing the normal direction
@@ -94,6 +134,50 @@ namespace tarragon
         //glVertexArrayAttribBinding(m_normal_vao, 0, 0);
     }
 
+    ChunkRenderer::~ChunkRenderer()
+    {
+        m_bindings.clear();
+        m_binding_handles.clear();
+        m_pvertex_arena = {};
+        m_pstaging_ring = {};
+        glDeleteVertexArrays(1, &m_vao);
+        glDeleteBuffers(1, &m_quad_index_buffer);
+        glDeleteBuffers(1, &m_draw_command_buffer);
+        glDeleteBuffers(1, &m_chunk_origin_buffer);
+    }
+
+    void ChunkRenderer::add_draw(ChunkBindings const& bindings)
+    {
+        if (bindings.index_count() == 0)
+            return;
+
+        auto index = static_cast<GLuint>(m_draw_commands.size());
+        m_draw_commands.push_back({ static_cast<GLuint>(bindings.index_count()), 1, 0, bindings.base_vertex(), index });
+        m_chunk_origins.push_back(glm::vec4{ bindings.world_position(), 0.0f });
+    }
+
+    void ChunkRenderer::upload_draws()
+    {
+        if (m_draw_commands.size() > m_draw_capacity)
+        {
+            m_draw_capacity = std::max({ m_draw_commands.size(), m_draw_capacity * 2, MinDrawCapacity });
+
+            glDeleteBuffers(1, &m_draw_command_buffer);
+            glDeleteBuffers(1, &m_chunk_origin_buffer);
+            glCreateBuffers(1, &m_draw_command_buffer);
+            glCreateBuffers(1, &m_chunk_origin_buffer);
+            glNamedBufferStorage(m_draw_command_buffer, sizeof(DrawElementsIndirectCommand) * m_draw_capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+            glNamedBufferStorage(m_chunk_origin_buffer, sizeof(glm::vec4) * m_draw_capacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+        }
+
+        if (!m_draw_commands.empty())
+        {
+            glNamedBufferSubData(m_draw_command_buffer, 0, sizeof(DrawElementsIndirectCommand) * m_draw_commands.size(), m_draw_commands.data());
+            glNamedBufferSubData(m_chunk_origin_buffer, 0, sizeof(glm::vec4) * m_chunk_origins.size(), m_chunk_origins.data());
+        }
+        m_draws_changed = false;
+    }
+
     void ChunkRenderer::initialize()
     {
         m_shader.add_shader_from_file(ShaderType::Vertex, { "shaders/chunk.vert" });
@@ -104,12 +188,32 @@ namespace tarragon
         //m_normal_shader.add_shader_from_file(ShaderType::Fragment, { "shaders/chunk_normals.frag" });
         //m_normal_shader.link();
 
+        m_culler.initialize();
+
+        m_pstaging_ring = std::make_unique<StagingRing>(StagingRingCapacity);
+
+        m_pvertex_arena = std::make_unique<GeometryArena>(sizeof(ChunkVertex), VertexArenaCapacity);
+
+        auto quad_indices = make_quad_indices();
+        glCreateBuffers(1, &m_quad_index_buffer);
+        glNamedBufferStorage(m_quad_index_buffer, sizeof(uint16_t) * quad_indices.size(), quad_indices.data(), 0);
+
+        glCreateVertexArrays(1, &m_vao);
+        glVertexArrayElementBuffer(m_vao, m_quad_index_buffer);
+
+        // Vertices are packed into one integer, see ChunkVertex. The vertex
+        // buffer is bound in draw(), as the arena's buffer changes when it grows.
+        glEnableVertexArrayAttrib(m_vao, 0);
+        glVertexArrayAttribIFormat(m_vao, 0, 1, GL_UNSIGNED_INT, 0);
+        glVertexArrayAttribBinding(m_vao, 0, 0);
+
         int width{}, height{}, channels{};
         unsigned char *pimage_data = stbi_load("res/rock-diffuse.png", &width, &height, &channels, 4);
 
         glCreateTextures(GL_TEXTURE_2D, 1, &m_rock_texture);
-        glTextureParameteri(m_rock_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTextureParameteri(m_rock_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        // Greedy meshes repeat the texture once per block
+        glTextureParameteri(m_rock_texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(m_rock_texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTextureParameteri(m_rock_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTextureParameteri(m_rock_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         glTextureStorage2D(m_rock_texture, 1, GL_RGBA8, width, height);
@@ -123,55 +227,104 @@ namespace tarragon
     {
         UNUSED_PARAM(clock);
 
-        Chunk* pgenchunk{};
-        if (m_pchunk_transfer->dequeue_to_render(&pgenchunk))
+        std::array<Chunk*, MaxChunksPerFrame> pchunks{};
+
+        m_pstaging_ring->reclaim();
+
+        auto render_count = m_pchunk_transfer->dequeue_to_render(pchunks);
+        for (size_t i = 0; i < render_count; i++)
         {
-            ChunkBindingsPtr pbinding = std::make_shared<ChunkBindings>(pgenchunk->extents());
-            pbinding->upload(pgenchunk->mesh());
-            m_bindings.push_back(pbinding);
+            auto pgenchunk = pchunks.at(i);
+            // Empty chunks are ready without a mesh, and are not drawn
+            if (pgenchunk->mesh() == nullptr)
+                continue;
+
+            ChunkBindings bindings{ pgenchunk->extents(), m_pvertex_arena.get() };
+            bindings.upload(pgenchunk->mesh(), *m_pstaging_ring);
+            m_binding_handles.insert(pgenchunk->chunk_index(), m_bindings.insert(std::move(bindings)));
+            m_draws_changed = true;
         }
 
-        Chunk* punloadchunk{};
-        if (m_pchunk_transfer->dequeue_to_unload(&punloadchunk))
+        m_pstaging_ring->fence();
+
+        auto unload_count = m_pchunk_transfer->dequeue_to_unload(pchunks);
+        for (size_t i = 0; i < unload_count; i++)
         {
-            // TODO: Implement better mapping from chunk to chunk bindings
-            ChunkBindingsPtr unload_bindings{};
-            for (auto it = std::cbegin(m_bindings); it != std::cend(m_bindings); it++)
+            auto punloadchunk = pchunks.at(i);
+
+            // Empty chunks have no bindings
+            auto phandle = m_binding_handles.find(punloadchunk->chunk_index());
+            if (phandle != nullptr)
             {
-                unload_bindings = *it;
-                if (unload_bindings->chunk_extents().origin() == punloadchunk->origin())
-                {
-                    m_bindings.erase(it);
-                    punloadchunk->clear_data();
-                    break;
-                }
+                m_bindings.erase(*phandle);
+                m_binding_handles.erase(punloadchunk->chunk_index());
+                m_draws_changed = true;
             }
+            punloadchunk->clear_data();
         }
     }
 
     void ChunkRenderer::draw()
-    {  
-        m_shader.use();
-        m_shader["View"].write(m_pcamera->view());
-        m_shader["Projection"].write(m_pcamera->projection());
-        
-        m_shader["L.position"].write(m_pcamera->position());
-        m_shader["L.ambient"].write(glm::vec3{ 0.3f, 0.3f, 0.3f });
-        m_shader["L.diffuse"].write(glm::vec3{ 0.8f, 0.8f, 0.8f });
-        m_shader["L.specular"].write(glm::vec3{ 1.0f, 1.0f, 1.0f });
-        m_shader["L.constant"].write(1.0f);
-        m_shader["L.linear"].write(0.045f);
-        m_shader["L.quadratic"].write(0.0075f);
-        
-        glBindTextureUnit(0, m_rock_texture);
-        m_shader["TexDiffuse"].write(0);
-
-        for (auto& pbindings : m_bindings)
+    {
+        auto view_projection = m_pcamera->projection() * m_pcamera->view();
+        if (m_culling_mode == CullingMode::Cpu)
         {
-            m_shader["Model"].write(pbindings->model());
+            m_draw_commands.clear();
+            m_chunk_origins.clear();
+            m_binding_handles.for_each_in_frustum(Frustum{ view_projection }, [this](ChunkIndex const&, SlotMap<ChunkBindings>::Handle handle)
+            {
+                add_draw(*m_bindings.get(handle));
+            });
+            upload_draws();
+        }
+        else if (m_draws_changed)
+        {
+            m_draw_commands.clear();
+            m_chunk_origins.clear();
+            for (auto const& bindings : m_bindings)
+                add_draw(bindings);
+            upload_draws();
+        }
 
-            glBindVertexArray(pbindings->vao());
-            glDrawElements(GL_TRIANGLES, pbindings->index_count(), GL_UNSIGNED_INT, nullptr);
+        if (!m_draw_commands.empty())
+        {
+            if (m_culling_mode == CullingMode::Gpu)
+                m_culler.cull(m_chunk_origin_buffer, m_draw_command_buffer, m_draw_commands.size(), Frustum{ view_projection });
+
+            m_shader.use();
+            m_shader["View"].write(m_pcamera->view());
+            m_shader["Projection"].write(m_pcamera->projection());
+
+            m_shader["L.position"].write(m_pcamera->position());
+            m_shader["L.ambient"].write(glm::vec3{ 0.3f, 0.3f, 0.3f });
+            m_shader["L.diffuse"].write(glm::vec3{ 0.8f, 0.8f, 0.8f });
+            m_shader["L.specular"].write(glm::vec3{ 1.0f, 1.0f, 1.0f });
+            m_shader["L.constant"].write(1.0f);
+            m_shader["L.linear"].write(0.045f);
+            m_shader["L.quadratic"].write(0.0075f);
+
+            glBindTextureUnit(0, m_rock_texture);
+            m_shader["TexDiffuse"].write(0);
+
+            glBindVertexArray(m_vao);
+            glVertexArrayVertexBuffer(m_vao, 0, m_pvertex_arena->buffer(), 0, sizeof(ChunkVertex));
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_chunk_origin_buffer);
+            if (m_culling_mode == CullingMode::Gpu)
+            {
+                // Only the chunks are drawn into the culler's framebuffer
+                m_culler.bind_framebuffer(m_pcamera->width(), m_pcamera->height());
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_culler.visible_draw_buffer());
+                glBindBuffer(GL_PARAMETER_BUFFER, m_culler.draw_count_buffer());
+                glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_SHORT, nullptr, 0, static_cast<GLsizei>(m_draw_commands.size()), 0);
+                m_culler.unbind_framebuffer();
+
+                m_culler.build_hiz(view_projection);
+            }
+            else
+            {
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_draw_command_buffer);
+                glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT, nullptr, static_cast<GLsizei>(m_draw_commands.size()), 0);
+            }
         }
 
         //m_normal_shader.use();
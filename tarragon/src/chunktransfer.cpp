@@ -1,5 +1,9 @@
 #include "chunktransfer.h"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include <glm/geometric.hpp>
 
 namespace tarragon
@@ -8,89 +12,157 @@ namespace tarragon
 	{
 		UNUSED_PARAM(clock);
 
+		update_load_priorities();
+
 		// Queue new chunks for loading
 		auto chunk_indices = m_pchunk_cache->chunk_indices_around(m_pcamera->position(), ChunkLoadDistance);
+		std::vector<Chunk*> pload_chunks{};
 		for (auto& index : chunk_indices)
 		{
 			auto pchunk = m_pchunk_cache->get_chunk_at(index);
 			if (pchunk->state() == ChunkState::Created)
-				enqueue_to_load(pchunk);
+				pload_chunks.push_back(pchunk);
 		}
+		enqueue_to_load(pload_chunks);
 
-		// Queue old chunks for unloading
-		for (auto pchunk : m_rendering_chunks)
+		// Chunks around the camera are loading now, the far away chunks that
+		// were unloaded can be destroyed
+		m_pchunk_cache->evict(glm::dvec3{ m_pcamera->position() });
+
+		// Queue old chunks for unloading. Chunks that don't fit into the
+		// queue are queued in a later frame.
+		m_rendering_chunks.for_each_beyond(glm::dvec3{ m_pcamera->position() }, ChunkUnloadThreshold, [this](ChunkIndex const&, Chunk* pchunk)
 		{
-			if (glm::distance(pchunk->center(), glm::dvec3{ m_pcamera->position() }) > ChunkUnloadThreshold && pchunk->state() == ChunkState::Ready)
-				enqueue_to_unload(pchunk);
-		}
+			return pchunk->state() != ChunkState::Ready || enqueue_to_unload(pchunk);
+		});
+	}
+
+	void ChunkTransfer::update_load_priorities()
+	{
+		auto position = m_pcamera->position();
+		auto forward = m_pcamera->forward();
+
+		std::lock_guard g{ m_load_mtx };
+
+		if (position == m_load_priority.Position && forward == m_load_priority.Forward)
+			return;
+
+		m_load_priority = { position, forward, m_pcamera->frustum() };
+		for (auto& request : m_load_queue)
+			request.Priority = m_load_priority(request.Target);
+		std::make_heap(std::begin(m_load_queue), std::end(m_load_queue), LoadOrder{});
 	}
 
 	void ChunkTransfer::enqueue_to_load(Chunk* pchunk)
 	{
-		std::lock_guard g{ m_queue_mtx };
+		enqueue_to_load(std::span<Chunk* const>{ &pchunk, 1 });
+	}
+
+	void ChunkTransfer::enqueue_to_load(std::span<Chunk* const> pchunks)
+	{
+		if (pchunks.empty())
+			return;
 
-		pchunk->state() = ChunkState::Loading;
-		m_load_queue.push(pchunk);
+		{
+			std::lock_guard g{ m_load_mtx };
+
+			auto now = std::chrono::steady_clock::now();
+			for (auto pchunk : pchunks)
+			{
+				pchunk->state() = ChunkState::Loading;
+				m_load_queue.push_back({ pchunk, m_load_priority(pchunk), now });
+				std::push_heap(std::begin(m_load_queue), std::end(m_load_queue), LoadOrder{});
+			}
+		}
+
+		if (pchunks.size() == 1)
+			m_load_cv.notify_one();
+		else
+			m_load_cv.notify_all();
+	}
+
+	Chunk* ChunkTransfer::pop_load_queue()
+	{
+		std::pop_heap(std::begin(m_load_queue), std::end(m_load_queue), LoadOrder{});
+		auto request = m_load_queue.back();
+		m_load_queue.pop_back();
+
+		m_load_latency.record(std::chrono::steady_clock::now() - request.EnqueueTime);
+		return request.Target;
 	}
 
 	bool ChunkTransfer::dequeue_to_load(Chunk** ppchunk)
 	{
 		*ppchunk = nullptr;
 
-		std::lock_guard g{ m_queue_mtx };
+		std::lock_guard g{ m_load_mtx };
 
 		if (m_load_queue.empty())
 			return false;
-		*ppchunk = m_load_queue.top();
-		m_load_queue.pop();
+		*ppchunk = pop_load_queue();
 		return true;
 	}
 
-	void ChunkTransfer::enqueue_to_render(Chunk* pchunk)
+	bool ChunkTransfer::wait_dequeue_to_load(Chunk** ppchunk, std::stop_token stop_token)
 	{
-		std::lock_guard g{ m_queue_mtx };
+		*ppchunk = nullptr;
 
+		std::unique_lock lock{ m_load_mtx };
+
+		if (!m_load_cv.wait(lock, stop_token, [this] { return !m_load_queue.empty(); }))
+			return false;
+		*ppchunk = pop_load_queue();
+		return true;
+	}
+
+	void ChunkTransfer::enqueue_to_render(Chunk* pchunk)
+	{
 		pchunk->state() = ChunkState::Ready;
-		m_finished_queue.push(std::move(pchunk));
+		while (!m_finished_queue.try_push(pchunk))
+			std::this_thread::yield();
 	}
 
 	bool ChunkTransfer::dequeue_to_render(Chunk** ppchunk)
 	{
 		*ppchunk = nullptr;
+		return dequeue_to_render(std::span<Chunk*>{ ppchunk, 1 }) == 1;
+	}
 
-		std::lock_guard g{ m_queue_mtx };
-
-		if (m_finished_queue.empty())
-			return false;
-		*ppchunk = m_finished_queue.front();
-		m_finished_queue.pop();
-
-		m_rendering_chunks.insert(*ppchunk);
-
-		return true;
+	size_t ChunkTransfer::dequeue_to_render(std::span<Chunk*> ppchunks)
+	{
+		// The workers are done with the chunks once they are queued
+		auto count = m_finished_queue.try_pop_batch(ppchunks);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_rendering_chunks.insert(ppchunks[i]->chunk_index(), ppchunks[i]);
+			m_pchunk_cache->add_chunk_data(ppchunks[i]);
+		}
+		return count;
 	}
 
-	void ChunkTransfer::enqueue_to_unload(Chunk* pchunk)
+	bool ChunkTransfer::enqueue_to_unload(Chunk* pchunk)
 	{
-		std::lock_guard g{ m_queue_mtx };
+		if (!m_unload_queue.try_push(pchunk))
+			return false;
 
 		pchunk->state() = ChunkState::Unloading;
-		m_unload_queue.push(std::move(pchunk));
+		return true;
 	}
 
 	bool ChunkTransfer::dequeue_to_unload(Chunk** ppchunk)
 	{
 		*ppchunk = nullptr;
+		return dequeue_to_unload(std::span<Chunk*>{ ppchunk, 1 }) == 1;
+	}
 
-		std::lock_guard g{ m_queue_mtx };
-
-		if (m_unload_queue.empty())
-			return false;
-		*ppchunk = m_unload_queue.front();
-		m_unload_queue.pop();
-
-		m_rendering_chunks.erase(*ppchunk);
-
-		return true;
+	size_t ChunkTransfer::dequeue_to_unload(std::span<Chunk*> ppchunks)
+	{
+		auto count = m_unload_queue.try_pop_batch(ppchunks);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_rendering_chunks.erase(ppchunks[i]->chunk_index());
+			m_pchunk_cache->remove_chunk_data(ppchunks[i]);
+		}
+		return count;
 	}
 }
@@ -1,167 +1,84 @@
 #include "chunkupdater.h"
 
-#include <array>
-#include <vector>
+#include <cstring>
 
 #include "common.h"
-#include "camera.h"
-
-#include <noise/modules.h>
-using namespace tarragon::noise;
 
 namespace tarragon
 {
-    namespace
+    void ChunkUpdater::generate_data_job(Chunk* pchunk)
     {
-        using QuadArray = std::array<glm::ivec3, 4>;
+        m_pworld->generate_data(pchunk);
 
-        static constexpr std::array<glm::vec3, 6> Normals6
-        {
-             Camera::RIGHT,   //right
-            -Camera::RIGHT,   //left
-             Camera::UP,      //top
-            -Camera::UP,      //bottom
-            -Camera::FORWARD, //front
-             Camera::FORWARD, //back
-        };
-
-        static constexpr std::array<glm::ivec3, 6> Neighbours6
+        // Empty chunks are ready without a mesh
+        if (pchunk->is_empty())
         {
-            glm::ivec3{ 1, 0, 0 },  //right
-            glm::ivec3{ -1, 0, 0 }, //left
-            glm::ivec3{ 0, 1, 0 },  //top
-            glm::ivec3{ 0, -1, 0 }, //bottom
-            glm::ivec3{ 0, 0, 1 },  //front
-            glm::ivec3{ 0, 0, -1 }, //back
-        };
-
-        static constexpr std::array<QuadArray, 6> NeighbourFaces
+            m_pchunk_transfer->enqueue_to_render(pchunk);
+            release_chunk_slot();
+            return;
+        }
+
+        m_job_pool.submit([this, pchunk] { generate_mesh_job(pchunk); });
+    }
+
+    void ChunkUpdater::generate_mesh_job(Chunk* pchunk)
+    {
+        auto mesh_data = generate_mesh(*pchunk, m_meshing_mode);
+        if (mesh_data.vertex_count() > 0)
         {
-            QuadArray //right
-            {
-                glm::ivec3{ 1, 1, 1 },
-                glm::ivec3{ 1, 1, 0 },
-                glm::ivec3{ 1, 0, 1 },
-                glm::ivec3{ 1, 0, 0 },
-            },
-            QuadArray //left
-            {
-                glm::ivec3{ 0, 1, 0 },
-                glm::ivec3{ 0, 1, 1 },
-                glm::ivec3{ 0, 0, 0 },
-                glm::ivec3{ 0, 0, 1 },
-            },
-            QuadArray //top
-            {
-                glm::ivec3{ 0, 1, 0 },
-                glm::ivec3{ 1, 1, 0 },
-                glm::ivec3{ 0, 1, 1 },
-                glm::ivec3{ 1, 1, 1 },
-            },
-            QuadArray //bottom
-            {
-                glm::ivec3{ 1, 0, 0 },
-                glm::ivec3{ 0, 0, 0 },
-                glm::ivec3{ 1, 0, 1 },
-                glm::ivec3{ 0, 0, 1 },
-            },
-            QuadArray //front
-            {
-                glm::ivec3{ 0, 1, 1 },
-                glm::ivec3{ 1, 1, 1 },
-                glm::ivec3{ 0, 0, 1 },
-                glm::ivec3{ 1, 0, 1 },
-            },
-            QuadArray //back
-            {
-                glm::ivec3{ 1, 1, 0 },
-                glm::ivec3{ 0, 1, 0 },
-                glm::ivec3{ 1, 0, 0 },
-                glm::ivec3{ 0, 0, 0 },
-            },
-        };
+            stage_vertices(mesh_data);
+            pchunk->set_mesh(std::move(mesh_data));
+        }
+
+        m_pchunk_transfer->enqueue_to_render(pchunk);
+        release_chunk_slot();
+    }
+
+    void ChunkUpdater::stage_vertices(ChunkMesh& mesh)
+    {
+        if (m_pstaging_ring == nullptr || mesh.Vertices.empty())
+            return;
+
+        auto size = sizeof(ChunkVertex) * mesh.Vertices.size();
+        auto offset = m_pstaging_ring->allocate(size);
+        if (!offset)
+            return;
+
+        std::memcpy(m_pstaging_ring->data(*offset), mesh.Vertices.data(), size);
+        mesh.Staged = ChunkMesh::StagedVertices{ *offset, mesh.Vertices.size() };
+        mesh.Vertices = {};
     }
 
-    ChunkMesh ChunkUpdater::generate_mesh(Chunk* chunk)
+    bool ChunkUpdater::acquire_chunk_slot(std::stop_token stop_token)
     {
-        ChunkMesh data{};
-        uint32_t index{};
+        std::unique_lock lock{ m_chunk_slots_mtx };
+
+        if (!m_chunk_slots_cv.wait(lock, stop_token, [this] { return m_free_chunk_slots > 0; }))
+            return false;
+        m_free_chunk_slots--;
+        return true;
+    }
 
-        for (size_t z = 0; z < Chunk::WIDTH; z++)
+    void ChunkUpdater::release_chunk_slot()
+    {
         {
-            for (size_t y = 0; y < Chunk::WIDTH; y++)
-            {
-                for (size_t x = 0; x < Chunk::WIDTH; x++)
-                {
-                    glm::size3 position{ x, y, z };
-
-                    auto block = chunk->at(position);
-                    if (block.Type == BlockType::Air)
-                        continue;
-
-                    for (size_t i = 0; i < Neighbours6.size(); i++)
-                    {
-                        auto& offset = Neighbours6.at(i);
-                        glm::ivec3 neighbour_pos = glm::ivec3{ position } + offset;
-
-                        if (((neighbour_pos.x < 0 || neighbour_pos.x >= static_cast<int>(Chunk::WIDTH))
-                            || (neighbour_pos.y < 0 || neighbour_pos.y >= static_cast<int>(Chunk::WIDTH))
-                            || (neighbour_pos.z < 0 || neighbour_pos.z >= static_cast<int>(Chunk::WIDTH)))
-                            || chunk->at(glm::size3{ neighbour_pos }).Type == BlockType::Air)
-                        {
-                            auto& quad = NeighbourFaces.at(i);
-                            for (size_t j = 0; j < quad.size(); j++)
-                            {
-                                data.Positions.push_back(glm::vec3{ glm::ivec3{position} + quad.at(j) });
-                            }
-
-                            data.Indices.push_back(index + 0);
-                            data.Indices.push_back(index + 1);
-                            data.Indices.push_back(index + 2);
-                            data.Indices.push_back(index + 1);
-                            data.Indices.push_back(index + 3);
-                            data.Indices.push_back(index + 2);
-
-                            auto const& normal = Normals6.at(i);
-                            data.Normals.push_back(normal);
-                            data.Normals.push_back(normal);
-                            data.Normals.push_back(normal);
-                            data.Normals.push_back(normal);
-
-                            data.TexCoords.push_back({ 0.0f, 0.0f });
-                            data.TexCoords.push_back({ 1.0f, 0.0f });
-                            data.TexCoords.push_back({ 0.0f, 1.0f });
-                            data.TexCoords.push_back({ 1.0f, 1.0f });
-
-                            index += 4;
-                        }
-                    }
-                }
-            }
+            std::lock_guard g{ m_chunk_slots_mtx };
+            m_free_chunk_slots++;
         }
-
-        data.WorldPosition = glm::vec3{ chunk->extents().origin() };
-        return data;
+        m_chunk_slots_cv.notify_one();
     }
 
-    void ChunkUpdater::work_thread_loop()
+    void ChunkUpdater::feed_thread_loop(std::stop_token stop_token)
     {
-        while (true)
+        // Take a slot before taking a chunk, so that chunks wait in the load
+        // queue, where they are ordered by distance to the camera.
+        while (acquire_chunk_slot(stop_token))
         {
             Chunk* pgenchunk{};
-            if (m_pchunk_transfer->dequeue_to_load(&pgenchunk))
-            {
-                m_pworld->generate_data(pgenchunk);
-
-                auto mesh_data = generate_mesh(pgenchunk);
-                pgenchunk->set_mesh(std::move(mesh_data));
-
-                m_pchunk_transfer->enqueue_to_render(pgenchunk);
+            if (!m_pchunk_transfer->wait_dequeue_to_load(&pgenchunk, stop_token))
+                break;
 
-                std::this_thread::yield();
-            }
-            else
-                std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
+            m_job_pool.submit([this, pgenchunk] { generate_data_job(pgenchunk); });
         }
     }
 
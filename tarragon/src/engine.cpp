@@ -153,7 +153,7 @@ namespace tarragon
         m_pchunk_renderer = std::make_unique<ChunkRenderer>(camera(), m_pchunk_transfer.get());
         m_pchunk_renderer->initialize();
 
-        m_pchunk_updater = std::make_unique<ChunkUpdater>(m_pchunk_transfer.get());
+        m_pchunk_updater = std::make_unique<ChunkUpdater>(m_pchunk_transfer.get(), m_pchunk_renderer->staging_ring());
         m_pchunk_updater->initialize();
 
         return true;
@@ -241,6 +241,24 @@ namespace tarragon
         glfwPollEvents();
     }
 
+    void Engine::draw_statistics()
+    {
+        auto const& load_latency = m_pchunk_transfer->load_latency();
+        auto to_ms = [](LatencyHistogram::Duration duration) { return std::chrono::duration<double, std::milli>{ duration }.count(); };
+
+        ImGui::Begin("Statistics");
+        ImGui::Text("Load queue latency (%llu chunks)", static_cast<unsigned long long>(load_latency.count()));
+        ImGui::Text("p50 < %.3f ms", to_ms(load_latency.quantile(0.5)));
+        ImGui::Text("p99 < %.3f ms", to_ms(load_latency.quantile(0.99)));
+        ImGui::Text("max < %.3f ms", to_ms(load_latency.quantile(1.0)));
+
+        auto cache = m_pchunk_cache->statistics();
+        ImGui::Separator();
+        ImGui::Text("Chunk cache: %llu chunks, %.1f MiB", static_cast<unsigned long long>(cache.LiveChunks), cache.BytesHeld / (1024.0 * 1024.0));
+        ImGui::Text("%llu evicted, %.2f%% hits", static_cast<unsigned long long>(cache.Evictions), cache.hit_rate() * 100.0);
+        ImGui::End();
+    }
+
     void Engine::draw()
     {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -250,6 +268,7 @@ namespace tarragon
         ImGui::NewFrame();
 
         ImGui::ShowDemoWindow();
+        draw_statistics();
 
         m_pchunk_renderer->draw();
 
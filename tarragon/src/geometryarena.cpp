@@ -0,0 +1,54 @@
+#include "geometryarena.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tarragon
+{
+    GeometryArena::GeometryArena(size_t element_size, size_t capacity)
+        : m_element_size{ element_size }
+        , m_allocator{ capacity }
+    {
+        glCreateBuffers(1, &m_buffer);
+        glNamedBufferStorage(m_buffer, static_cast<GLsizeiptr>(element_size * capacity), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+
+    GeometryArena::~GeometryArena()
+    {
+        glDeleteBuffers(1, &m_buffer);
+    }
+
+    void GeometryArena::grow(size_t min_capacity)
+    {
+        auto old_capacity = m_allocator.capacity();
+        auto capacity = std::max(old_capacity * 2, min_capacity);
+
+        GLuint buffer{};
+        glCreateBuffers(1, &buffer);
+        glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(m_element_size * capacity), nullptr, GL_DYNAMIC_STORAGE_BIT);
+        glCopyNamedBufferSubData(m_buffer, buffer, 0, 0, static_cast<GLsizeiptr>(m_element_size * old_capacity));
+        glDeleteBuffers(1, &m_buffer);
+
+        m_buffer = buffer;
+        m_allocator.grow(capacity);
+    }
+
+    size_t GeometryArena::allocate(size_t count)
+    {
+        assert(count > 0);
+
+        auto offset = m_allocator.allocate(count);
+        if (!offset)
+        {
+            grow(m_allocator.capacity() + count);
+            offset = m_allocator.allocate(count);
+            assert(offset);
+        }
+        return *offset;
+    }
+
+    void GeometryArena::free(size_t offset, size_t count)
+    {
+        m_allocator.free(offset, count);
+    }
+}
@@ -0,0 +1,119 @@
+#include "stagingring.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tarragon
+{
+    StagingRing::StagingRing(size_t capacity)
+        : m_capacity{ capacity }
+    {
+        assert(capacity % Alignment == 0);
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &m_buffer);
+        glNamedBufferStorage(m_buffer, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+        m_pmapped = static_cast<std::byte*>(glMapNamedBufferRange(m_buffer, 0, static_cast<GLsizeiptr>(capacity), flags));
+    }
+
+    StagingRing::~StagingRing()
+    {
+        for (auto const& fence : m_fences)
+            glDeleteSync(fence.Sync);
+
+        glUnmapNamedBuffer(m_buffer);
+        glDeleteBuffers(1, &m_buffer);
+    }
+
+    std::optional<size_t> StagingRing::allocate(size_t size)
+    {
+        auto aligned_size = (size + Alignment - 1) & ~(Alignment - 1);
+        if (aligned_size == 0 || aligned_size > m_capacity)
+            return {};
+
+        std::lock_guard g{ m_mtx };
+
+        if (m_allocations.empty())
+            m_head = m_tail = 0;
+
+        size_t offset{};
+        if (m_allocations.empty() || m_head > m_tail)
+        {
+            // The used space doesn't wrap around, so there is room at the
+            // end and at the start of the buffer
+            if (m_capacity - m_head >= aligned_size)
+                offset = m_head;
+            else if (m_tail >= aligned_size)
+                offset = 0;
+            else
+                return {};
+        }
+        else
+        {
+            if (m_tail - m_head >= aligned_size)
+                offset = m_head;
+            else
+                return {};
+        }
+
+        m_allocations.push_back({ offset, offset + aligned_size, false, 0 });
+        m_head = offset + aligned_size;
+        return offset;
+    }
+
+    void StagingRing::retire(size_t offset)
+    {
+        std::lock_guard g{ m_mtx };
+
+        auto it = std::ranges::find_if(m_allocations, [offset](Allocation const& allocation)
+        {
+            return allocation.Offset == offset && !allocation.Retired;
+        });
+        assert(it != std::end(m_allocations));
+        it->Retired = true;
+    }
+
+    void StagingRing::fence()
+    {
+        bool fenced{};
+        {
+            std::lock_guard g{ m_mtx };
+            for (auto& allocation : m_allocations)
+            {
+                if (allocation.Retired && allocation.Serial == 0)
+                {
+                    allocation.Serial = m_next_serial;
+                    fenced = true;
+                }
+            }
+        }
+
+        if (fenced)
+            m_fences.push_back({ m_next_serial++, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+    }
+
+    void StagingRing::reclaim()
+    {
+        while (!m_fences.empty())
+        {
+            auto status = glClientWaitSync(m_fences.front().Sync, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+
+            m_signalled_serial = m_fences.front().Serial;
+            glDeleteSync(m_fences.front().Sync);
+            m_fences.pop_front();
+        }
+
+        std::lock_guard g{ m_mtx };
+        while (!m_allocations.empty())
+        {
+            auto const& allocation = m_allocations.front();
+            if (!allocation.Retired || allocation.Serial == 0 || allocation.Serial > m_signalled_serial)
+                break;
+
+            m_tail = allocation.End;
+            m_allocations.pop_front();
+        }
+    }
+}
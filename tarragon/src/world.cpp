@@ -1,8 +1,12 @@
 #include "world.h"
 
+#include <vector>
+
+#include <noise/expressions.h>
+
 namespace tarragon
 {
-    Block World::map_value(double value)
+    Block World::map_value(float value)
     {
         if (value > m_air_threshold)
             return Block{ BlockType::Rock };
@@ -11,31 +15,74 @@ namespace tarragon
     }
 
     World::World()
+        : m_source{ terrain() }
     {
-        Module xdisp = Billow(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 0);
-        Module ydisp = Billow(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 1);
-        Module zdisp = Billow(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, 2);
-        m_source = Displace(RidgedMulti(1 / 72.0, 2.3, 14, NoiseQuality::Best, 0),
-            xdisp, ydisp, zdisp);
+    }
+
+    FloatModule World::terrain()
+    {
+        // Block thresholds don't need double precision, so generate in float.
+        // The graph is composed as one expression so that it compiles into a
+        // single function. Its graph nodes give the value ranges that tell
+        // which chunks are all rock or air.
+        auto displacement = [](int32_t seed)
+        {
+            return expr::billow<float>(1 / 15, 3, 8, 0.5, NoiseQuality::Standard, seed);
+        };
+        return expr::displace(
+            expr::ridged_multi<float>(1 / 72.0, 2.3, 14, NoiseQuality::Best, 0),
+            displacement(0),
+            displacement(1),
+            displacement(2)).type_erase();
     }
 
     void World::generate_data(Chunk* pchunk)
     {
-        for (size_t z = 0; z < Chunk::WIDTH; z++)
+        // Generate one block beyond each face as well. Generation is
+        // deterministic, so these are exactly the blocks the neighbouring
+        // chunks will contain, and meshing can cull faces against them.
+        constexpr size_t padded_width = Chunk::WIDTH + 2;
+        Grid grid
+        {
+            pchunk->extents().origin() - glm::dvec3{ Chunk::Extents::BLOCK_SIZE },
+            glm::dvec3{ Chunk::Extents::BLOCK_SIZE },
+            glm::size3{ padded_width },
+        };
+
+        // Skip sampling chunks whose values all lie on one side of the
+        // threshold, which is most chunks far above or below the surface
+        auto range = graph::value_range(m_source.node(), Box<float>
+        {
+            glm::vec3{ grid.Origin },
+            glm::vec3{ grid.Origin + grid.Step * glm::dvec3{ padded_width - 1 } },
+        });
+        if (range.Lower > m_air_threshold || range.Upper <= m_air_threshold)
         {
-            for (size_t y = 0; y < Chunk::WIDTH; y++)
+            pchunk->fill(map_value(range.Lower));
+            return;
+        }
+
+        std::vector<float> values(grid.count());
+        m_source(grid, values);
+
+        constexpr int width = static_cast<int>(Chunk::WIDTH);
+        size_t value_index{};
+        for (int z = -1; z <= width; z++)
+        {
+            for (int y = -1; y <= width; y++)
             {
-                for (size_t x = 0; x < Chunk::WIDTH; x++)
+                for (int x = -1; x <= width; x++, value_index++)
                 {
-                    glm::size3 index{ x, y, z };
-
-                    auto sample_position = pchunk->extents().world_position_at_index(index);
-                    auto value = m_source(sample_position);
+                    glm::ivec3 index{ x, y, z };
 
-                    Block block = map_value(value);
-                    pchunk->set_at(index, block);
+                    Block block = map_value(values[value_index]);
+                    if (x >= 0 && x < width && y >= 0 && y < width && z >= 0 && z < width)
+                        pchunk->set_at(glm::size3{ index }, block);
+                    else if (Chunk::is_border(index))
+                        pchunk->set_border_at(index, block);
                 }
             }
         }
+        pchunk->compact_data();
     }
 }